@@ -0,0 +1,137 @@
+#ifndef ABSENCE_DETECTOR_H
+#define ABSENCE_DETECTOR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "CompressedBitmap.h"
+
+// A pair's attendance fell below the limit
+struct AbsenceAlert {
+    int student;        // 0-based
+    int subject;
+    int day;            // Day of the session that triggered it
+    bool byDays;        // Day window (else session window)
+    uint32_t attended;
+    uint32_t held;      // Sessions in the window
+};
+
+// When AbsenceDetector raises an alert
+struct AbsenceRules {
+    int sessionWindow = 10;   // Last this many sessions (at most 64)
+    int dayWindow = 30;       // Sessions in the last this many days (at most 64 sessions)
+    double minRate = 0.75;    // Alert below this fraction attended
+    int minSessions = 5;      // Windows with fewer sessions never alert
+};
+
+// Early warning for chronic absence, updated as sessions are recorded.
+//
+// Every (student, subject) pair keeps the presence of its last 64 sessions
+// as the bits of one word, newest in bit 0. The rate over the last N
+// sessions is then a popcount of the low N bits. For the day window, each
+// subject keeps the days of its recent sessions, so the number of sessions
+// inside the window is known and the same popcount applies. Each present or
+// absent student costs O(1), and the day queue is trimmed by amortized O(1)
+// per session: nothing is ever rescanned.
+//
+// An alert fires when a rate drops below the limit and fires again only
+// after the rate has recovered. Sessions count in the order they arrive.
+class AbsenceDetector {
+public:
+    static const int HISTORY = 64;  // Longest window, in sessions
+
+    struct Rates {
+        uint32_t sessionAttended = 0, sessionHeld = 0;
+        uint32_t dayAttended = 0, dayHeld = 0;
+    };
+
+    AbsenceDetector(int students, int subjects, AbsenceRules rules = AbsenceRules())
+        : students(students), rules(rules),
+          history(static_cast<size_t>(students) * subjects, 0),
+          flags(static_cast<size_t>(students) * subjects, 0),
+          sessionsHeld(subjects, 0), recentDays(subjects) {
+        if (this->rules.sessionWindow > HISTORY) this->rules.sessionWindow = HISTORY;
+    }
+
+    const AbsenceRules& settings() const { return rules; }
+
+    // One session of a subject: the 0-based students taking it and a
+    // bitset of who was present. Alerts raised by it are appended to alerts.
+    void onSession(int subject, int day, const std::vector<int>& takers, const uint64_t* present,
+                   std::vector<AbsenceAlert>& alerts) {
+        sessionsHeld[subject]++;
+        std::deque<int>& days = recentDays[subject];
+        days.push_back(day);
+        while (days.size() > static_cast<size_t>(HISTORY) || days.front() <= day - rules.dayWindow) days.pop_front();
+
+        const uint32_t sessionHeld = window(subject, rules.sessionWindow);
+        const uint32_t dayHeld = static_cast<uint32_t>(days.size());
+        const uint64_t sessionMask = lowBits(sessionHeld);
+        const uint64_t dayMask = lowBits(dayHeld);
+
+        for (int student : takers) {
+            size_t pair = index(student, subject);
+            uint64_t bits = (history[pair] << 1) | ((present[student / 64] >> (student % 64)) & 1);
+            history[pair] = bits;
+
+            check(pair, SESSION_FLAG, static_cast<uint32_t>(popcount64(bits & sessionMask)), sessionHeld,
+                  AbsenceAlert{student, subject, day, false, 0, 0}, alerts);
+            check(pair, DAY_FLAG, static_cast<uint32_t>(popcount64(bits & dayMask)), dayHeld,
+                  AbsenceAlert{student, subject, day, true, 0, 0}, alerts);
+        }
+    }
+
+    // A pair's current windows (student 0-based)
+    Rates rates(int student, int subject) const {
+        Rates r;
+        uint64_t bits = history[index(student, subject)];
+        r.sessionHeld = window(subject, rules.sessionWindow);
+        r.sessionAttended = static_cast<uint32_t>(popcount64(bits & lowBits(r.sessionHeld)));
+        r.dayHeld = static_cast<uint32_t>(recentDays[subject].size());
+        r.dayAttended = static_cast<uint32_t>(popcount64(bits & lowBits(r.dayHeld)));
+        return r;
+    }
+
+    // True while the pair is below the limit in either window
+    bool flagged(int student, int subject) const { return flags[index(student, subject)] != 0; }
+
+private:
+    static const uint8_t SESSION_FLAG = 1;
+    static const uint8_t DAY_FLAG = 2;
+
+    size_t index(int student, int subject) const {
+        return static_cast<size_t>(subject) * students + student;
+    }
+
+    uint32_t window(int subject, int length) const {
+        return static_cast<uint32_t>(std::min<uint64_t>(sessionsHeld[subject], length));
+    }
+
+    static uint64_t lowBits(uint32_t count) {
+        return count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+    }
+
+    // Raise an alert on the way down, re-arm on the way back up
+    void check(size_t pair, uint8_t flag, uint32_t attended, uint32_t held, AbsenceAlert alert,
+               std::vector<AbsenceAlert>& alerts) {
+        bool below = held >= static_cast<uint32_t>(rules.minSessions) && attended < rules.minRate * held;
+        if (below && !(flags[pair] & flag)) {
+            flags[pair] |= flag;
+            alert.attended = attended;
+            alert.held = held;
+            alerts.push_back(alert);
+        } else if (!below) {
+            flags[pair] &= ~flag;
+        }
+    }
+
+    int students;
+    AbsenceRules rules;
+    std::vector<uint64_t> history;   // Per pair, subject-major: presence bits, newest lowest
+    std::vector<uint8_t> flags;      // Per pair: windows currently below the limit
+    std::vector<uint64_t> sessionsHeld;       // Per subject
+    std::vector<std::deque<int>> recentDays;  // Per subject: days of the sessions in the day window
+};
+
+#endif
@@ -1,358 +1,2071 @@
-#include <iostream>
-#include <fstream>
-#include <string>
-#include <vector>
-#include <map>
-
-using namespace std;
-
-class SchoolAttendance {
-private:
-    const int TOTAL_STUDENTS = 50;
-    const int TOTAL_SUBJECTS = 11;
-
-    vector<string> subjects = {
-        "Mathematics", "English", "Kiswahili", "Chemistry", "Biology",
-        "Physics", "Computer", "Geology", "History", "C.R.E","Business"
-    };
-
-    // Track attendance: student_id -> (subject_index -> count)
-    vector<vector<int>> attendance;
-
-    // Track which subjects each student takes
-    vector<vector<int>> studentSubjects;
-
-public:
-    SchoolAttendance() {
-        // Initialize attendance records with zeros
-        attendance.resize(TOTAL_STUDENTS, vector<int>(TOTAL_SUBJECTS, 0));
-        studentSubjects.resize(TOTAL_STUDENTS);
-        setupStudentSubjects();
-    }
-
-    void setupStudentSubjects() {
-        cout << "Setting up student subjects...\n";
-
-        // All students take mandatory subjects (0-5)
-        for (int student = 0; student < TOTAL_STUDENTS; student++) {
-            for (int subject = 0; subject <= 5; subject++) {
-                studentSubjects[student].push_back(subject);
-            }
-        }
-
-        // Assign optional subjects based on capacities
-        int physicsCount = 0, geologyCount = 0, historyCount = 0, creCount = 0;
-
-        for (int student = 0; student < TOTAL_STUDENTS; student++) {
-            // Physics + 1 humanity (30 students)
-            if (student < 30 && physicsCount < 35) {
-                studentSubjects[student].push_back(5); // Physics
-                physicsCount++;
-
-                // Add one humanity
-                if (creCount < 30) {
-                    studentSubjects[student].push_back(9); // C.R.E
-                    creCount++;
-                } else if (historyCount < 40) {
-                    studentSubjects[student].push_back(8); // History
-                    historyCount++;
-                } else if (geologyCount < 20) {
-                    studentSubjects[student].push_back(7); // Geology
-                    geologyCount++;
-                }
-            }
-            // Two humanities only (20 students)
-            else if (student >= 30 && student < 50) {
-                int humanities = 0;
-                if (creCount < 30) {
-                    studentSubjects[student].push_back(9); // C.R.E
-                    creCount++;
-                    humanities++;
-                }
-                if (humanities < 2 && historyCount < 40) {
-                    studentSubjects[student].push_back(8); // History
-                    historyCount++;
-                    humanities++;
-                }
-                if (humanities < 2 && geologyCount < 20) {
-                    studentSubjects[student].push_back(7); // Geology
-                    geologyCount++;
-                }
-            }
-        }
-
-        cout << "Subject setup completed!\n";
-        cout << "Physics: " << physicsCount << "/35\n";
-        cout << "Geology: " << geologyCount << "/20\n";
-        cout << "History: " << historyCount << "/40\n";
-        cout << "C.R.E: " << creCount << "/30\n";
-    }
-
-    void markAttendance(int studentId, int subjectId) {
-        if (studentId < 1 || studentId > TOTAL_STUDENTS) {
-            cout << "Error: Student ID must be between 1 and " << TOTAL_STUDENTS << "\n";
-            return;
-        }
-
-        if (subjectId < 0 || subjectId >= TOTAL_SUBJECTS) {
-            cout << "Error: Subject ID must be between 0 and " << TOTAL_SUBJECTS-1 << "\n";
-            return;
-        }
-
-        // Check if student takes this subject
-        bool takesSubject = false;
-        for (int subj : studentSubjects[studentId-1]) {
-            if (subj == subjectId) {
-                takesSubject = true;
-                break;
-            }
-        }
-
-        if (!takesSubject) {
-            cout << "Error: Student " << studentId << " doesn't take " << subjects[subjectId] << "!\n";
-            return;
-        }
-
-        attendance[studentId-1][subjectId]++;
-        cout << "Marked attendance for Student " << studentId
-                  << " in " << subjects[subjectId] << "\n";
-    }
-
-    void showStudentAttendance(int studentId) {
-        if (studentId < 1 || studentId > TOTAL_STUDENTS) {
-            cout << "Error: Invalid student ID!\n";
-            return;
-        }
-
-        cout << "\n=== Attendance for Student " << studentId << " ===\n";
-        int total = 0;
-
-        for (int subjectId : studentSubjects[studentId-1]) {
-            int count = attendance[studentId-1][subjectId];
-            cout << subjects[subjectId] << ": " << count << " sessions\n";
-            total += count;
-        }
-        cout << "Total: " << total << " sessions\n";
-    }
-
-    void showSubjectAttendance(int subjectId) {
-        if (subjectId < 0 || subjectId >= TOTAL_SUBJECTS) {
-            cout << "Error: Invalid subject ID!\n";
-            return;
-        }
-
-        cout << "\n=== Attendance for " << subjects[subjectId] << " ===\n";
-        int total = 0, studentCount = 0;
-
-        for (int student = 0; student < TOTAL_STUDENTS; student++) {
-            for (int subj : studentSubjects[student]) {
-                if (subj == subjectId) {
-                    int count = attendance[student][subjectId];
-                    cout << "Student " << student+1 << ": " << count << " sessions\n";
-                    total += count;
-                    studentCount++;
-                    break;
-                }
-            }
-        }
-
-        cout << "Total students: " << studentCount << "\n";
-        cout << "Total sessions: " << total << "\n";
-    }
-
-    void saveStudentReport(int studentId) {
-        if (studentId < 1 || studentId > TOTAL_STUDENTS) {
-            cout << "Error: Invalid student ID!\n";
-            return;
-        }
-
-        string filename = "student_" + to_string(studentId) + "_report.txt";
-        ofstream file(filename);
-
-        file << "STUDENT ATTENDANCE REPORT\n";
-        file << "Student ID: " << studentId << "\n\n";
-        file << "SUBJECT ATTENDANCE:\n";
-
-        int total = 0;
-        for (int subjectId : studentSubjects[studentId-1]) {
-            int count = attendance[studentId-1][subjectId];
-            file << subjects[subjectId] << ": " << count << " sessions\n";
-            total += count;
-        }
-
-        file << "\nTOTAL SESSIONS: " << total << "\n";
-        file.close();
-        cout << "Report saved to: " << filename << "\n";
-    }
-
-    void saveSubjectReport(int subjectId) {
-        if (subjectId < 0 || subjectId >= TOTAL_SUBJECTS) {
-            cout << "Error: Invalid subject ID!\n";
-            return;
-        }
-
-        string filename = subjects[subjectId] + "_report.txt";
-        ofstream file(filename);
-
-        file << "SUBJECT ATTENDANCE REPORT\n";
-        file << "Subject: " << subjects[subjectId] << "\n\n";
-        file << "STUDENT ATTENDANCE:\n";
-
-        int total = 0, studentCount = 0;
-        for (int student = 0; student < TOTAL_STUDENTS; student++) {
-            for (int subj : studentSubjects[student]) {
-                if (subj == subjectId) {
-                    int count = attendance[student][subjectId];
-                    file << "Student " << student+1 << ": " << count << " sessions\n";
-                    total += count;
-                    studentCount++;
-                    break;
-                }
-            }
-        }
-
-        file << "\nSUMMARY:\n";
-        file << "Total students: " << studentCount << "\n";
-        file << "Total sessions: " << total << "\n";
-        file.close();
-        cout << "Report saved to: " << filename << "\n";
-    }
-
-    void saveAllReports() {
-        ofstream file("school_report.txt");
-
-        file << "SCHOOL WIDE ATTENDANCE REPORT\n\n";
-
-        // Subject summary
-        file << "SUBJECT SUMMARY:\n";
-        for (int subjectId = 0; subjectId < TOTAL_SUBJECTS; subjectId++) {
-            int total = 0, studentCount = 0;
-            for (int student = 0; student < TOTAL_STUDENTS; student++) {
-                for (int subj : studentSubjects[student]) {
-                    if (subj == subjectId) {
-                        total += attendance[student][subjectId];
-                        studentCount++;
-                        break;
-                    }
-                }
-            }
-            file << subjects[subjectId] << ": " << studentCount << " students, "
-                 << total << " sessions\n";
-        }
-
-        file << "\nSTUDENT SUMMARY:\n";
-        for (int student = 0; student < TOTAL_STUDENTS; student++) {
-            int total = 0;
-            for (int subjectId : studentSubjects[student]) {
-                total += attendance[student][subjectId];
-            }
-            file << "Student " << student+1 << ": " << total << " total sessions\n";
-        }
-
-        file.close();
-        cout << "School report saved to: school_report.txt\n";
-    }
-
-    void showSubjects() {
-        cout << "\n=== SUBJECTS ===\n";
-        for (int i = 0; i < TOTAL_SUBJECTS; i++) {
-            cout << i << ". " << subjects[i] << "\n";
-        }
-    }
-
-    void showStudentSubjects(int studentId) {
-        if (studentId < 1 || studentId > TOTAL_STUDENTS) {
-            cout << "Error: Invalid student ID!\n";
-            return;
-        }
-
-        cout << "\nStudent " << studentId << " takes: ";
-        for (int subjectId : studentSubjects[studentId-1]) {
-            cout << subjects[subjectId] << " ";
-        }
-        cout << "\n";
-    }
-};
-
-int main() {
-    SchoolAttendance school;
-    int choice;
-
-    cout << "=== SCHOOL ATTENDANCE SYSTEM ===\n";
-    cout << "50 Students | 10 Subjects\n\n";
-
-    do {
-        cout << "\n=== MAIN MENU ===\n";
-        cout << "1. Mark Attendance\n";
-        cout << "2. View Student Attendance\n";
-        cout << "3. View Subject Attendance\n";
-        cout << "4. Save Student Report\n";
-        cout << "5. Save Subject Report\n";
-        cout << "6. Save All Reports\n";
-        cout << "7. Show Subjects List\n";
-        cout << "8. Show Student's Subjects\n";
-        cout << "9. Exit\n";
-        cout << "Choose option: ";
-        cin >> choice;
-
-        switch (choice) {
-            case 1: {
-                int studentId, subjectId;
-                cout << "Enter student ID (1-50): ";
-                cin >> studentId;
-                cout << "Enter subject ID (0-10): ";
-                cin >> subjectId;
-                school.markAttendance(studentId, subjectId);
-                break;
-            }
-            case 2: {
-                int studentId;
-                cout << "Enter student ID (1-50): ";
-                cin >> studentId;
-                school.showStudentAttendance(studentId);
-                break;
-            }
-            case 3: {
-                int subjectId;
-                cout << "Enter subject ID (0-10): ";
-                cin >> subjectId;
-                school.showSubjectAttendance(subjectId);
-                break;
-            }
-            case 4: {
-                int studentId;
-                cout << "Enter student ID (1-50): ";
-                cin >> studentId;
-                school.saveStudentReport(studentId);
-                break;
-            }
-            case 5: {
-                int subjectId;
-                cout << "Enter subject ID (0-10): ";
-                cin >> subjectId;
-                school.saveSubjectReport(subjectId);
-                break;
-            }
-            case 6:
-                school.saveAllReports();
-                break;
-            case 7:
-                school.showSubjects();
-                break;
-            case 8: {
-                int studentId;
-                cout << "Enter student ID (1-50): ";
-                cin >> studentId;
-                school.showStudentSubjects(studentId);
-                break;
-            }
-            case 9:
-                cout << "Goodbye!\n";
-                break;
-            default:
-                cout << "Invalid choice! Try again.\n";
-        }
-    } while (choice != 9);
-
-    return 0;
-}
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <cstdio>
+#include <cstddef>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+#include "CompressedBitmap.h"
+#include "MpmcQueue.h"
+#include "SubjectAllocator.h"
+#include "ThreadPool.h"
+#include "AbsenceDetector.h"
+#include "ReportWriter.h"
+#include "Storage.h"
+
+using namespace std;
+
+// Attendance counts for every (student, subject) pair in one contiguous,
+// cache-line aligned block of 16-bit counters. Rows are subjects, so a
+// subject's students are adjacent in memory and whole-school totals are a
+// linear sweep. Each row is padded to whole cache lines.
+class AttendanceMatrix {
+public:
+    static const size_t CACHE_LINE = 64;
+    static const uint16_t MAX_COUNT = UINT16_MAX;  // Counters stop here
+
+    AttendanceMatrix(int studentCount, int subjectCount)
+        : studentCount(studentCount), subjectCount(subjectCount), stride(strideFor(studentCount)) {
+        cells = static_cast<uint16_t*>(::operator new(bytes(), align_val_t(CACHE_LINE)));
+        memset(cells, 0, bytes());
+    }
+
+    ~AttendanceMatrix() { release(); }
+
+    AttendanceMatrix(const AttendanceMatrix&) = delete;
+    AttendanceMatrix& operator=(const AttendanceMatrix&) = delete;
+
+    int students() const { return studentCount; }
+    int subjects() const { return subjectCount; }
+
+    // Counters per row: students rounded up to whole cache lines
+    static size_t strideFor(int studentCount) {
+        const size_t perLine = CACHE_LINE / sizeof(uint16_t);
+        return (static_cast<size_t>(studentCount) + perLine - 1) / perLine * perLine;
+    }
+
+    // Switch to counters kept elsewhere (a mapped file) with exactly this
+    // layout. The current counts are dropped; the memory is not freed here.
+    void rebind(uint16_t* external) {
+        release();
+        cells = external;
+        ownsCells = false;
+    }
+
+    // Size of the whole block, padding included
+    size_t bytes() const { return stride * subjectCount * sizeof(uint16_t); }
+
+    uint16_t get(int student, int subject) const { return cells[subject * stride + student]; }
+
+    // Count one more session (false once the counter is full)
+    bool increment(int student, int subject) {
+        uint16_t& cell = cells[subject * stride + student];
+        if (cell == MAX_COUNT) return false;
+        cell++;
+        return true;
+    }
+
+    void set(int student, int subject, uint16_t count) { cells[subject * stride + student] = count; }
+
+    // All students' counts for one subject, indexed by 0-based student
+    const uint16_t* row(int subject) const { return cells + subject * stride; }
+
+    // Count one more session in a subject for every student whose bit is
+    // set (bit s % 64 of word s / 64 for 0-based student s), adding the same
+    // to studentTotals[s]. The inner loop has no branches, so the compiler
+    // can vectorize it. Returns how many of those counters were already
+    // full and stayed unchanged.
+    uint32_t incrementAll(int subject, const uint64_t* studentBits, uint32_t* studentTotals) {
+        uint16_t* counts = cells + subject * stride;
+        uint32_t full = 0;
+        for (int word = 0; word * 64 < studentCount; word++) {
+            uint64_t bits = studentBits[word];
+            if (bits == 0) continue;
+            uint16_t* block = counts + word * 64;
+            uint32_t* totals = studentTotals + word * 64;
+            int end = min(64, studentCount - word * 64);
+            for (int i = 0; i < end; i++) {
+                uint16_t bit = static_cast<uint16_t>((bits >> i) & 1);
+                uint16_t room = block[i] != MAX_COUNT;
+                full += bit & (room ^ 1);
+                block[i] += bit & room;
+                totals[i] += bit & room;
+            }
+        }
+        return full;
+    }
+
+private:
+    void release() {
+        if (ownsCells) ::operator delete(cells, align_val_t(CACHE_LINE));
+    }
+
+    int studentCount;
+    int subjectCount;
+    size_t stride;      // Counters per row (students rounded up to a cache line)
+    uint16_t* cells;
+    bool ownsCells = true;
+};
+
+// ===== Dates =====
+// Dates are kept as day numbers: days since 1970-01-01.
+
+int daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// Parse "YYYY-MM-DD" (false if it is not a real date)
+bool parseDate(const string& text, int& dayNumber) {
+    int year, month, day;
+    char extra;
+    if (sscanf(text.c_str(), "%d-%d-%d%c", &year, &month, &day, &extra) != 3) return false;
+    static const int monthDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (month < 1 || month > 12 || day < 1) return false;
+    if (day > monthDays[month - 1] + (month == 2 && leap)) return false;
+    dayNumber = daysFromCivil(year, month, day);
+    return true;
+}
+
+string formatDate(int dayNumber) {
+    dayNumber += 719468;
+    int era = (dayNumber >= 0 ? dayNumber : dayNumber - 146096) / 146097;
+    int dayOfEra = dayNumber - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int mp = (5 * dayOfYear + 2) / 153;
+    int day = dayOfYear - (153 * mp + 2) / 5 + 1;
+    int month = mp + (mp < 10 ? 3 : -9);
+    int year = yearOfEra + era * 400 + (month <= 2);
+
+    char text[32];
+    snprintf(text, sizeof(text), "%04d-%02d-%02d", year, month, day);
+    return text;
+}
+
+// ===== Session register =====
+// One class session: a subject taught on a date, and who attended.
+// Most students attend, so a session keeps whichever set is smaller: the
+// students present or the students absent (of those taking the subject).
+struct ClassSession {
+    int id;
+    int day;
+    int subject;
+    uint32_t enrolled;          // Students taking the subject that day
+    bool storesAbsent;
+    CompressedBitmap students;  // 0-based student numbers
+
+    uint32_t presentCount() const {
+        uint32_t listed = static_cast<uint32_t>(students.cardinality());
+        return storesAbsent ? enrolled - listed : listed;
+    }
+
+    // Only meaningful for students taking the subject
+    bool wasPresent(int student) const {
+        return students.contains(static_cast<uint32_t>(student)) != storesAbsent;
+    }
+};
+
+// Every session held, with per-subject date indexes for range queries
+class SessionRegister {
+public:
+    explicit SessionRegister(int subjectCount) : bySubject(subjectCount) {}
+
+    // Record a session. takers (the subject's students) and present are
+    // sorted 0-based student numbers, with present a subset of takers.
+    const ClassSession& add(int subject, int day, const vector<int>& takers,
+                            const vector<uint32_t>& present) {
+        ClassSession session;
+        session.id = static_cast<int>(sessions.size()) + 1;
+        session.day = day;
+        session.subject = subject;
+        session.enrolled = static_cast<uint32_t>(takers.size());
+        session.storesAbsent = present.size() * 2 > takers.size();
+        if (session.storesAbsent) {
+            vector<uint32_t> absent;
+            absent.reserve(takers.size() - present.size());
+            size_t p = 0;
+            for (int student : takers) {
+                if (p < present.size() && present[p] == static_cast<uint32_t>(student)) {
+                    p++;
+                } else {
+                    absent.push_back(static_cast<uint32_t>(student));
+                }
+            }
+            session.students = CompressedBitmap::fromSorted(absent);
+        } else {
+            session.students = CompressedBitmap::fromSorted(present);
+        }
+        sessions.push_back(move(session));
+
+        // Keep the subject's index in date order (sessions usually arrive in order)
+        auto& index = bySubject[subject];
+        pair<int, int> entry(day, sessions.back().id);
+        index.insert(upper_bound(index.begin(), index.end(), entry), entry);
+        return sessions.back();
+    }
+
+    size_t size() const { return sessions.size(); }
+
+    // Sessions of a subject held between two dates (inclusive), in date order
+    vector<const ClassSession*> between(int subject, int fromDay, int toDay) const {
+        vector<const ClassSession*> found;
+        const auto& index = bySubject[subject];
+        auto it = lower_bound(index.begin(), index.end(), make_pair(fromDay, 0));
+        for (; it != index.end() && it->first <= toDay; ++it) {
+            found.push_back(&sessions[it->second - 1]);
+        }
+        return found;
+    }
+
+    // Memory used by the attendance sets
+    size_t bytes() const {
+        size_t total = 0;
+        for (const ClassSession& session : sessions) {
+            total += sizeof(ClassSession) + session.students.bytes();
+        }
+        return total;
+    }
+
+private:
+    vector<ClassSession> sessions;            // Session id - 1 -> session
+    vector<vector<pair<int, int>>> bySubject; // Subject -> (day, session id), sorted
+};
+
+// ===== Durable store =====
+//
+// attendance.dat keeps the counters and the subject sets in the same layout
+// as memory, so a restart maps the file instead of parsing anything:
+//   [0, 4096)        two 512-byte header slots; of the valid ones, the one
+//                    with the higher checkpoint number is current
+//   countersOffset   the AttendanceMatrix block, byte for byte
+//   masksOffset      the subject masks, maskWords words per student
+//
+// The file is mapped copy-on-write, so marking only changes memory. Every
+// change is also appended to a redo log as the counters' new values (or,
+// when subjects are allocated again, the students' new masks). A
+// checkpoint writes the changed rows and masks into the file and syncs, then writes
+// the other header slot with the next checkpoint number and syncs, and only
+// then empties the log. Whenever a crash happens, the newest valid header
+// plus the log give the last state: records hold absolute values, so
+// replaying one over a row already written back changes nothing, and a torn
+// record at the end of the log is dropped.
+struct AttendanceStoreHeader {
+    char magic[8];            // "SATTEND1"
+    uint32_t version;
+    uint32_t byteOrder;       // BYTE_ORDER_MARK as stored by the writer
+    uint64_t checkpoint;      // Higher is newer
+    uint32_t students;
+    uint32_t subjects;
+    uint32_t maskWords;
+    uint32_t unused;
+    uint64_t stride;          // Counters per subject row
+    uint64_t countersOffset;
+    uint64_t masksOffset;
+    uint64_t fileSize;
+    uint32_t checksum;        // CRC-32 of everything before it
+    uint32_t padding;
+};
+
+class AttendanceStore {
+public:
+    static const uint32_t VERSION = 1;
+    static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static const size_t SLOT_SIZE = 512;
+    static const size_t HEADER_SIZE = 4096;
+    static const size_t CHECKPOINT_LOG_BYTES = 4 << 20;  // Fold the log back in past this
+    static const uint32_t MASK_RECORD = UINT32_MAX;     // In place of a subject: a run of masks
+
+    AttendanceStore() = default;
+    AttendanceStore(const AttendanceStore&) = delete;
+    AttendanceStore& operator=(const AttendanceStore&) = delete;
+    ~AttendanceStore() { close(); }
+
+    // Size of the school in an existing store (false if missing or damaged)
+    static bool readSize(const string& path, int& students, int& subjects) {
+        MappedFile file;
+        AttendanceStoreHeader header;
+        if (!file.open(path) || !currentHeader(file.data(), file.size(), header)) return false;
+        students = static_cast<int>(header.students);
+        subjects = static_cast<int>(header.subjects);
+        return true;
+    }
+
+    // Write a new store holding these counters (an AttendanceMatrix block)
+    // and subject masks. It is built under a temporary name and renamed into
+    // place, and any old log is removed first, so a crash leaves either no
+    // store or a complete one.
+    static bool create(const string& path, const string& logPath, int students, int subjects,
+                       int maskWords, const uint16_t* counters, const uint64_t* masks) {
+        AttendanceStoreHeader header = {};
+        memcpy(header.magic, "SATTEND1", sizeof(header.magic));
+        header.version = VERSION;
+        header.byteOrder = BYTE_ORDER_MARK;
+        header.checkpoint = 1;
+        header.students = static_cast<uint32_t>(students);
+        header.subjects = static_cast<uint32_t>(subjects);
+        header.maskWords = static_cast<uint32_t>(maskWords);
+        header.stride = AttendanceMatrix::strideFor(students);
+        header.countersOffset = HEADER_SIZE;
+        size_t counterBytes = header.stride * subjects * sizeof(uint16_t);
+        header.masksOffset = alignUp(header.countersOffset + counterBytes);
+        size_t maskBytes = static_cast<size_t>(students) * maskWords * sizeof(uint64_t);
+        header.fileSize = alignUp(header.masksOffset + maskBytes);
+        header.checksum = headerChecksum(header);
+
+        vector<char> image(header.fileSize, 0);
+        memcpy(image.data() + slotOffset(header.checkpoint), &header, sizeof(header));  // The other slot stays invalid
+        memcpy(image.data() + header.countersOffset, counters, counterBytes);
+        memcpy(image.data() + header.masksOffset, masks, maskBytes);
+
+        string temp = path + ".tmp";
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+        if (fd < 0) return false;
+        bool ok = writeAll(fd, image.data(), image.size()) && fsync(fd) == 0;
+        ::close(fd);
+        remove(logPath.c_str());
+        if (!ok || rename(temp.c_str(), path.c_str()) != 0) {
+            remove(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Map an existing store for a school of this size and replay its log
+    // into the mapping. Returns false if the file is missing, damaged or
+    // of another size.
+    bool open(const string& path, const string& logPath, int students, int subjects, int maskWords) {
+        close();
+        if (!file.open(path, true) || !currentHeader(file.data(), file.size(), header) ||
+            header.students != static_cast<uint32_t>(students) ||
+            header.subjects != static_cast<uint32_t>(subjects) ||
+            header.maskWords != static_cast<uint32_t>(maskWords)) {
+            file.close();
+            return false;
+        }
+        dirtyRows.assign(subjects, 0);
+        masksDirty = false;
+
+        replayed = 0;
+        dataFd = ::open(path.c_str(), O_WRONLY | O_BINARY);
+        if (dataFd < 0 || !log.open(logPath, [this](const char* payload, size_t length) {
+                return replayRecord(payload, length);
+            })) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // The mapped counters and masks (the counters may be changed in place,
+    // as long as every change is logged)
+    uint16_t* counters() { return reinterpret_cast<uint16_t*>(file.writableData() + header.countersOffset); }
+    const uint64_t* masks() const { return reinterpret_cast<const uint64_t*>(file.data() + header.masksOffset); }
+    uint64_t* writableMasks() { return reinterpret_cast<uint64_t*>(file.writableData() + header.masksOffset); }
+
+    size_t replayedRecords() const { return replayed; }
+
+    // Record the current values of count counters of a subject, starting at
+    // 0-based student first. They reach the OS at once; the fsync is
+    // batched with their neighbours.
+    bool logCounts(int subject, int first, int count, const uint16_t* values) {
+        if (dataFd < 0) return false;
+
+        uint32_t fields[3] = {static_cast<uint32_t>(subject), static_cast<uint32_t>(first),
+                              static_cast<uint32_t>(count)};
+        record.assign(reinterpret_cast<const char*>(fields), sizeof(fields));
+        record.append(reinterpret_cast<const char*>(values), count * sizeof(uint16_t));
+        if (!log.append(record)) return false;
+        dirtyRows[subject] = 1;
+
+        if (log.size() >= CHECKPOINT_LOG_BYTES) return checkpoint();
+        return true;
+    }
+
+    // Replace the subject masks of count students from 0-based student
+    // first (maskWords words each) and log them, like logCounts()
+    bool logMasks(int first, int count, const uint64_t* words) {
+        if (dataFd < 0) return false;
+
+        size_t bytes = static_cast<size_t>(count) * header.maskWords * sizeof(uint64_t);
+        memcpy(writableMasks() + static_cast<size_t>(first) * header.maskWords, words, bytes);
+        uint32_t fields[3] = {MASK_RECORD, static_cast<uint32_t>(first), static_cast<uint32_t>(count)};
+        record.assign(reinterpret_cast<const char*>(fields), sizeof(fields));
+        record.append(reinterpret_cast<const char*>(words), bytes);
+        if (!log.append(record)) return false;
+        masksDirty = true;
+
+        if (log.size() >= CHECKPOINT_LOG_BYTES) return checkpoint();
+        return true;
+    }
+
+    // Force every logged change to stable storage
+    bool sync() { return log.sync(); }
+
+    // Write the changed rows back into the file, switch header slots and
+    // empty the log (see the layout notes above for the order)
+    bool checkpoint() {
+        if (dataFd < 0 || !sync()) return false;
+
+        const uint16_t* cells = counters();
+        size_t rowBytes = header.stride * sizeof(uint16_t);
+        for (uint32_t subject = 0; subject < header.subjects; subject++) {
+            if (!dirtyRows[subject]) continue;
+            if (!writeAt(dataFd, header.countersOffset + subject * rowBytes,
+                         reinterpret_cast<const char*>(cells + subject * header.stride), rowBytes)) {
+                return false;
+            }
+        }
+        if (masksDirty && !writeAt(dataFd, header.masksOffset, reinterpret_cast<const char*>(masks()),
+                                   uint64_t(header.students) * header.maskWords * sizeof(uint64_t))) {
+            return false;
+        }
+        if (fsync(dataFd) != 0) return false;
+
+        AttendanceStoreHeader next = header;
+        next.checkpoint++;
+        next.checksum = headerChecksum(next);
+        if (!writeAt(dataFd, slotOffset(next.checkpoint), reinterpret_cast<const char*>(&next), sizeof(next)) ||
+            fsync(dataFd) != 0) {
+            return false;
+        }
+        header = next;
+
+        if (!log.reset()) return false;
+        fill(dirtyRows.begin(), dirtyRows.end(), 0);
+        masksDirty = false;
+        return true;
+    }
+
+    void close() {
+        log.close();
+        if (dataFd >= 0) ::close(dataFd);
+        dataFd = -1;
+        file.close();
+    }
+
+    bool isOpen() const { return dataFd >= 0; }
+    size_t logSize() const { return log.size(); }
+
+private:
+    static size_t alignUp(size_t offset) {
+        return (offset + AttendanceMatrix::CACHE_LINE - 1) / AttendanceMatrix::CACHE_LINE * AttendanceMatrix::CACHE_LINE;
+    }
+
+    static size_t slotOffset(uint64_t checkpoint) { return (checkpoint % 2) * SLOT_SIZE; }
+
+    static uint32_t headerChecksum(const AttendanceStoreHeader& header) {
+        return crc32(reinterpret_cast<const char*>(&header), offsetof(AttendanceStoreHeader, checksum));
+    }
+
+    static bool validHeader(const AttendanceStoreHeader& h, size_t fileSize) {
+        if (memcmp(h.magic, "SATTEND1", sizeof(h.magic)) != 0 || h.version != VERSION ||
+            h.byteOrder != BYTE_ORDER_MARK || h.checksum != headerChecksum(h) || h.fileSize != fileSize) {
+            return false;
+        }
+        return h.students > 0 && h.subjects > 0 && h.maskWords == (h.subjects + 63) / 64 &&
+               h.stride == AttendanceMatrix::strideFor(static_cast<int>(h.students)) &&
+               h.countersOffset >= HEADER_SIZE && h.countersOffset % AttendanceMatrix::CACHE_LINE == 0 &&
+               h.countersOffset + h.stride * h.subjects * sizeof(uint16_t) <= h.masksOffset &&
+               h.masksOffset % sizeof(uint64_t) == 0 &&
+               h.masksOffset + uint64_t(h.students) * h.maskWords * sizeof(uint64_t) <= fileSize;
+    }
+
+    // The valid slot with the higher checkpoint number
+    static bool currentHeader(const char* data, size_t size, AttendanceStoreHeader& out) {
+        if (size < HEADER_SIZE) return false;
+        bool found = false;
+        for (size_t slot = 0; slot < 2; slot++) {
+            AttendanceStoreHeader h;
+            memcpy(&h, data + slot * SLOT_SIZE, sizeof(h));
+            if (validHeader(h, size) && slotOffset(h.checkpoint) == slot * SLOT_SIZE &&
+                (!found || h.checkpoint > out.checkpoint)) {
+                out = h;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    static bool writeAt(int fd, uint64_t offset, const char* data, size_t len) {
+        return lseek(fd, static_cast<off_t>(offset), SEEK_SET) == static_cast<off_t>(offset) &&
+               writeAll(fd, data, len);
+    }
+
+    // Apply one intact log record to the mapping (false if it does not fit
+    // this store)
+    bool replayRecord(const char* body, size_t length) {
+        uint32_t fields[3];
+        if (length < sizeof(fields)) return false;
+        memcpy(fields, body, sizeof(fields));
+        uint32_t subject = fields[0], first = fields[1], count = fields[2];
+        if (first > header.students || count > header.students - first) return false;
+        if (subject == MASK_RECORD) {
+            size_t bytes = static_cast<size_t>(count) * header.maskWords * sizeof(uint64_t);
+            if (length != sizeof(fields) + bytes) return false;
+            memcpy(writableMasks() + static_cast<size_t>(first) * header.maskWords, body + sizeof(fields), bytes);
+            masksDirty = true;
+            replayed++;
+            return true;
+        }
+        if (subject >= header.subjects || length != sizeof(fields) + count * sizeof(uint16_t)) return false;
+        memcpy(counters() + subject * header.stride + first, body + sizeof(fields), count * sizeof(uint16_t));
+        dirtyRows[subject] = 1;
+        replayed++;
+        return true;
+    }
+
+    MappedFile file;          // Private (copy-on-write) mapping of the store
+    AttendanceStoreHeader header = {};
+    int dataFd = -1;
+    Journal log;              // Redo log
+    vector<char> dirtyRows;   // Subject rows changed since the last checkpoint
+    bool masksDirty = false;  // Masks changed since the last checkpoint
+    size_t replayed = 0;
+    string record;            // Reused log record buffer
+};
+
+class SchoolAttendance {
+private:
+    const int TOTAL_STUDENTS;
+    const int TOTAL_SUBJECTS;
+
+    vector<string> subjects = {
+        "Mathematics", "English", "Kiswahili", "Chemistry", "Biology",
+        "Physics", "Computer", "Geology", "History", "C.R.E","Business"
+    };
+
+    // Sessions attended per (student, subject)
+    AttendanceMatrix attendance;
+
+    // Dated record of every session held
+    SessionRegister sessionRegister;
+
+    // Sliding-window attendance rates, fed by recorded sessions, and every
+    // alert raised so far
+    AbsenceDetector absenceDetector;
+    vector<AbsenceAlert> absenceAlerts;
+
+    // Totals kept up to date on every mark, so summaries never recount:
+    // sessions per subject (all students) and per student (all subjects).
+    // Students per subject is subjectStudents[subject].size().
+    vector<uint64_t> subjectTotals;
+    vector<uint32_t> studentTotals;
+
+    // Which subjects each student takes: one bit per subject, maskWords
+    // 64-bit words per student (student-major)
+    int maskWords;
+    vector<uint64_t> subjectMasks;
+
+    // Students taking each subject, 0-based and in increasing order
+    vector<vector<int>> subjectStudents;
+
+    // The same as bitsets: studentWords 64-bit words per subject
+    // (bit s % 64 of word s / 64 for 0-based student s)
+    int studentWords;
+    vector<uint64_t> enrollmentBits;
+
+    // Where the counters and subject sets are kept between runs (none for
+    // an in-memory school)
+    unique_ptr<AttendanceStore> store;
+
+    // Reports whose data changed since generateAllReports() last wrote
+    // them: a bitset over 0-based students (studentWords words), a flag per
+    // subject, and one for the school report. Everything starts dirty.
+    vector<uint64_t> dirtyStudents;
+    vector<char> dirtySubjects;
+    bool schoolReportDirty = true;
+    unique_ptr<ThreadPool> reportPool;  // Started on first use
+
+    void markDirty(int student, int subject) {
+        dirtyStudents[student / 64] |= uint64_t(1) << (student % 64);
+        dirtySubjects[subject] = 1;
+        schoolReportDirty = true;
+    }
+
+    // Add a subject to a student's set (ignored if already taken)
+    void assignSubject(int student, int subject) {
+        uint64_t& word = subjectMasks[student * maskWords + subject / 64];
+        uint64_t bit = uint64_t(1) << (subject % 64);
+        if (word & bit) return;
+        word |= bit;
+        enrollmentBits[subject * studentWords + student / 64] |= uint64_t(1) << (student % 64);
+
+        // Usually an append: setup assigns students in increasing order
+        vector<int>& list = subjectStudents[subject];
+        list.insert(upper_bound(list.begin(), list.end(), student), student);
+    }
+
+    // Optional subject places: the original class of 50 had Geology 20,
+    // History 40 and C.R.E 30, scaled to the school's size; the other
+    // optional subjects take 10 per 50 students
+    vector<int> defaultCapacities() const {
+        auto scaled = [this](int forFifty) { return forFifty * TOTAL_STUDENTS / 50; };
+        vector<int> capacity(TOTAL_SUBJECTS, scaled(10));
+        for (int subject = 0; subject < MANDATORY_SUBJECTS; subject++) capacity[subject] = 0;
+        capacity[GEOLOGY] = scaled(20);
+        capacity[HISTORY] = scaled(40);
+        capacity[CRE] = scaled(30);
+        return capacity;
+    }
+
+    // Stand-in preferences until real ones are collected: as in the original
+    // class, three in five students want one humanity and the rest two, with
+    // the humanities in random order. Two of any numbered subjects follow as
+    // fallbacks. The same every run.
+    vector<SubjectPreferences> defaultPreferences() const {
+        mt19937 rng(2024);
+        const int humanitiesList[] = {GEOLOGY, HISTORY, CRE};
+        vector<SubjectPreferences> preferences(TOTAL_STUDENTS);
+        for (SubjectPreferences& prefs : preferences) {
+            prefs.wanted = rng() % 5 < 3 ? 1 : 2;
+            vector<int> humanities(begin(humanitiesList), end(humanitiesList));
+            shuffle(humanities.begin(), humanities.end(), rng);
+            prefs.ranked.insert(prefs.ranked.end(), humanities.begin(), humanities.end());
+            for (int extra = 0; extra < 2 && TOTAL_SUBJECTS > NAMED_SUBJECTS; extra++) {
+                int subject = NAMED_SUBJECTS + rng() % (TOTAL_SUBJECTS - NAMED_SUBJECTS);
+                if (find(prefs.ranked.begin(), prefs.ranked.end(), subject) == prefs.ranked.end()) {
+                    prefs.ranked.push_back(subject);
+                }
+            }
+        }
+        return preferences;
+    }
+
+    // Rebuild the student lists and enrollment bitsets from the masks
+    void rebuildSubjectSets() {
+        for (vector<int>& list : subjectStudents) list.clear();
+        fill(enrollmentBits.begin(), enrollmentBits.end(), 0);
+        for (int student = 0; student < TOTAL_STUDENTS; student++) {
+            for (int subject = 0; subject < TOTAL_SUBJECTS; subject++) {
+                if (!takesSubject(student, subject)) continue;
+                subjectStudents[subject].push_back(student);
+                enrollmentBits[subject * studentWords + student / 64] |= uint64_t(1) << (student % 64);
+            }
+        }
+    }
+
+    // Recount the kept totals from the counters
+    void rebuildTotals() {
+        fill(subjectTotals.begin(), subjectTotals.end(), 0);
+        fill(studentTotals.begin(), studentTotals.end(), 0);
+        for (int subjectId = 0; subjectId < TOTAL_SUBJECTS; subjectId++) {
+            const uint16_t* counts = attendance.row(subjectId);
+            for (int student = 0; student < TOTAL_STUDENTS; student++) {
+                subjectTotals[subjectId] += counts[student];
+                studentTotals[student] += counts[student];
+            }
+        }
+    }
+
+    // Use the store at path: load it if it exists, otherwise set up the
+    // subjects and create it. Without a usable store the school still
+    // works, but nothing is saved.
+    void openStore(const string& path, const string& logPath) {
+        bool exists = ifstream(path).is_open();
+        store.reset(new AttendanceStore());
+        if (exists && store->open(path, logPath, TOTAL_STUDENTS, TOTAL_SUBJECTS, maskWords)) {
+            memcpy(subjectMasks.data(), store->masks(), subjectMasks.size() * sizeof(uint64_t));
+            attendance.rebind(store->counters());
+            rebuildSubjectSets();
+            rebuildTotals();
+            cout << "Loaded attendance from " << path;
+            if (store->replayedRecords() > 0) cout << " (" << store->replayedRecords() << " logged changes replayed)";
+            cout << "\n";
+            return;
+        }
+
+        setupStudentSubjects();
+        if (exists) {
+            cout << "Error: " << path << " is damaged or for another school size; changes will not be saved!\n";
+        } else if (!AttendanceStore::create(path, logPath, TOTAL_STUDENTS, TOTAL_SUBJECTS, maskWords,
+                                            attendance.row(0), subjectMasks.data()) ||
+                   !store->open(path, logPath, TOTAL_STUDENTS, TOTAL_SUBJECTS, maskWords)) {
+            cout << "Error: Cannot create " << path << "; changes will not be saved!\n";
+        } else {
+            attendance.rebind(store->counters());
+            cout << "Created " << path << "\n";
+            return;
+        }
+        store.reset();
+    }
+
+    // Log every student's subject mask, so a new allocation survives a
+    // restart (in runs of students, to keep each log record small)
+    void logSubjectMasks() {
+        if (!store || !store->isOpen()) return;  // Setup before the store exists
+        const int RUN = 1 << 14;
+        for (int first = 0; first < TOTAL_STUDENTS; first += RUN) {
+            int count = min(RUN, TOTAL_STUDENTS - first);
+            if (!store->logMasks(first, count, &subjectMasks[static_cast<size_t>(first) * maskWords])) {
+                cout << "Error: Cannot write the attendance log!\n";
+                return;
+            }
+        }
+        syncStore();
+    }
+
+    // Log the current values of a run of a subject's counters
+    void logCounts(int subjectId, int first, int count) {
+        if (store && !store->logCounts(subjectId, first, count, attendance.row(subjectId) + first)) {
+            cout << "Error: Cannot write the attendance log!\n";
+        }
+    }
+
+    bool takesSubject(int student, int subject) const {
+        return (subjectMasks[student * maskWords + subject / 64] >> (subject % 64)) & 1;
+    }
+
+    // A student's subjects in increasing order
+    vector<int> subjectsOf(int student) const {
+        vector<int> taken;
+        for (int subject = 0; subject < TOTAL_SUBJECTS; subject++) {
+            if (takesSubject(student, subject)) taken.push_back(subject);
+        }
+        return taken;
+    }
+
+    // Built with -DATTENDANCE_DEBUG_VERIFY, every change re-checks all the
+    // totals against the counters and stops at the first mismatch
+    void checkAggregates() const {
+#ifdef ATTENDANCE_DEBUG_VERIFY
+        if (!verifyAggregates()) {
+            cout << "Error: Attendance totals no longer match the counters!\n";
+            abort();
+        }
+#endif
+    }
+
+public:
+    static const int DEFAULT_STUDENTS = 50;
+    static const int NAMED_SUBJECTS = 11;  // Subjects with names above; more are numbered
+    static const int MANDATORY_SUBJECTS = 6;  // Subjects 0-5 (through Physics) are taken by everyone
+    enum OptionalSubject { COMPUTER = 6, GEOLOGY = 7, HISTORY = 8, CRE = 9, BUSINESS = 10 };
+
+    // With a store path, the counters and subject sets are kept in that file
+    // (see AttendanceStore) and changes are logged to logPath
+    SchoolAttendance(int totalStudents = DEFAULT_STUDENTS, int totalSubjects = NAMED_SUBJECTS,
+                     const string& storePath = "", const string& logPath = "")
+        : TOTAL_STUDENTS(totalStudents),
+          TOTAL_SUBJECTS(max(totalSubjects, NAMED_SUBJECTS)),
+          attendance(TOTAL_STUDENTS, TOTAL_SUBJECTS),
+          sessionRegister(TOTAL_SUBJECTS),
+          absenceDetector(TOTAL_STUDENTS, TOTAL_SUBJECTS) {
+        for (int subject = NAMED_SUBJECTS; subject < TOTAL_SUBJECTS; subject++) {
+            subjects.push_back("Subject " + to_string(subject));
+        }
+        maskWords = (TOTAL_SUBJECTS + 63) / 64;
+        subjectMasks.assign(static_cast<size_t>(TOTAL_STUDENTS) * maskWords, 0);
+        subjectStudents.resize(TOTAL_SUBJECTS);
+        studentWords = (TOTAL_STUDENTS + 63) / 64;
+        enrollmentBits.assign(static_cast<size_t>(TOTAL_SUBJECTS) * studentWords, 0);
+        subjectTotals.assign(TOTAL_SUBJECTS, 0);
+        studentTotals.assign(TOTAL_STUDENTS, 0);
+        dirtyStudents.assign(studentWords, ~uint64_t(0));
+        if (TOTAL_STUDENTS % 64) dirtyStudents.back() = (uint64_t(1) << (TOTAL_STUDENTS % 64)) - 1;
+        dirtySubjects.assign(TOTAL_SUBJECTS, 1);
+        if (storePath.empty()) {
+            setupStudentSubjects();
+        } else {
+            openStore(storePath, logPath);
+        }
+    }
+
+    bool isPersistent() const { return store != nullptr; }
+
+    // Make every logged change durable (cheap when nothing is waiting)
+    void syncStore() {
+        if (store && !store->sync()) cout << "Error: Cannot sync the attendance log!\n";
+    }
+
+    // Fold the log back into the store file
+    void saveStore() {
+        if (!store) return;
+        if (store->checkpoint()) {
+            cout << "Attendance saved.\n";
+        } else {
+            cout << "Error: Cannot save attendance!\n";
+        }
+    }
+
+    int studentCount() const { return TOTAL_STUDENTS; }
+    int studentWordCount() const { return studentWords; }
+    int subjectCount() const { return TOTAL_SUBJECTS; }
+
+    // Read-only views for code that works next to the menu (no ID checks)
+    const uint64_t* enrollmentRow(int subjectId) const { return &enrollmentBits[subjectId * studentWords]; }
+    uint16_t attendanceCount(int studentId, int subjectId) const { return attendance.get(studentId-1, subjectId); }
+    uint64_t subjectTotal(int subjectId) const { return subjectTotals[subjectId]; }
+    uint32_t studentTotal(int studentId) const { return studentTotals[studentId-1]; }
+
+    // Everyone takes the mandatory subjects; the optional ones are shared
+    // out by SubjectAllocator from preferences and capacities
+    void setupStudentSubjects() {
+        cout << "Setting up student subjects...\n";
+
+        vector<int> capacity = defaultCapacities();
+        SubjectAllocation result = allocateSubjects(defaultPreferences(), capacity);
+
+        cout << "Subject setup completed!\n";
+        for (int subject = MANDATORY_SUBJECTS; subject < TOTAL_SUBJECTS; subject++) {
+            cout << subjects[subject] << ": " << result.filled[subject] << "/" << capacity[subject] << "\n";
+        }
+        cout << "Places by choice:";
+        for (size_t rank = 0; rank < result.byRank.size(); rank++) {
+            cout << " #" << rank + 1 << " " << result.byRank[rank];
+        }
+        cout << "\n";
+        if (result.studentsShort > 0) {
+            cout << "Unmet preferences: " << result.studentsShort << " students are short of "
+                 << result.placesShort << " optional subjects\n";
+        }
+    }
+
+    // Give every student the mandatory subjects, then as many of their
+    // preferred optional subjects as the capacities allow (preferences and
+    // capacities are indexed by 0-based student and by subject ID).
+    // Subjects already assigned are kept. With a store, the new subject
+    // sets are logged so they survive a restart.
+    SubjectAllocation allocateSubjects(const vector<SubjectPreferences>& preferences,
+                                       const vector<int>& capacity) {
+        for (int student = 0; student < TOTAL_STUDENTS; student++) {
+            for (int subject = 0; subject < MANDATORY_SUBJECTS; subject++) {
+                assignSubject(student, subject);
+            }
+        }
+
+        SubjectAllocator allocator;
+        SubjectAllocation result = allocator.solve(capacity, preferences);
+        for (int student = 0; student < TOTAL_STUDENTS && student < static_cast<int>(preferences.size()); student++) {
+            for (int subject : result.assigned[student]) assignSubject(student, subject);
+        }
+        logSubjectMasks();
+        return result;
+    }
+
+    void markAttendance(int studentId, int subjectId) {
+        if (studentId < 1 || studentId > TOTAL_STUDENTS) {
+            cout << "Error: Student ID must be between 1 and " << TOTAL_STUDENTS << "\n";
+            return;
+        }
+
+        if (subjectId < 0 || subjectId >= TOTAL_SUBJECTS) {
+            cout << "Error: Subject ID must be between 0 and " << TOTAL_SUBJECTS-1 << "\n";
+            return;
+        }
+
+        if (!takesSubject(studentId-1, subjectId)) {
+            cout << "Error: Student " << studentId << " doesn't take " << subjects[subjectId] << "!\n";
+            return;
+        }
+
+        if (!attendance.increment(studentId-1, subjectId)) {
+            cout << "Error: Attendance count for Student " << studentId << " is full!\n";
+            return;
+        }
+        subjectTotals[subjectId]++;
+        studentTotals[studentId-1]++;
+        logCounts(subjectId, studentId-1, 1);
+        markDirty(studentId-1, subjectId);
+        checkAggregates();
+        cout << "Marked attendance for Student " << studentId
+                  << " in " << subjects[subjectId] << "\n";
+    }
+
+    void showStudentAttendance(int studentId) {
+        if (studentId < 1 || studentId > TOTAL_STUDENTS) {
+            cout << "Error: Invalid student ID!\n";
+            return;
+        }
+
+        ReportWriter out;
+        out << "\n=== Attendance for Student " << studentId << " ===\n";
+        for (int subjectId : subjectsOf(studentId-1)) {
+            out << subjects[subjectId] << ": " << attendance.get(studentId-1, subjectId) << " sessions\n";
+        }
+        out << "Total: " << studentTotals[studentId-1] << " sessions\n";
+    }
+
+    // Number of students taking a subject (0 for an invalid ID)
+    int subjectStudentCount(int subjectId) const {
+        if (subjectId < 0 || subjectId >= TOTAL_SUBJECTS) return 0;
+        return static_cast<int>(subjectStudents[subjectId].size());
+    }
+
+    // The range selects which of the subject's students are listed; the
+    // totals always cover all of them
+    void showSubjectAttendance(int subjectId, RowRange range = RowRange()) {
+        if (subjectId < 0 || subjectId >= TOTAL_SUBJECTS) {
+            cout << "Error: Invalid subject ID!\n";
+            return;
+        }
+
+        ReportWriter out;
+        out << "\n=== Attendance for " << subjects[subjectId] << " ===\n";
+        const vector<int>& takers = subjectStudents[subjectId];
+        const uint16_t* counts = attendance.row(subjectId);
+        for (size_t i = range.begin(takers.size()); i < range.end(takers.size()); i++) {
+            out << "Student " << takers[i]+1 << ": " << counts[takers[i]] << " sessions\n";
+        }
+
+        out << "Total students: " << takers.size() << "\n";
+        out << "Total sessions: " << subjectTotals[subjectId] << "\n";
+    }
+
+    // The text of a student's report file (any valid ID)
+    void renderStudentReport(ReportWriter& file, int studentId) const {
+        file << "STUDENT ATTENDANCE REPORT\n";
+        file << "Student ID: " << studentId << "\n\n";
+        file << "SUBJECT ATTENDANCE:\n";
+
+        for (int subjectId : subjectsOf(studentId-1)) {
+            file << subjects[subjectId] << ": " << attendance.get(studentId-1, subjectId) << " sessions\n";
+        }
+
+        file << "\nTOTAL SESSIONS: " << studentTotals[studentId-1] << "\n";
+    }
+
+    // The text of a subject's report file (any valid ID)
+    void renderSubjectReport(ReportWriter& file, int subjectId) const {
+        file << "SUBJECT ATTENDANCE REPORT\n";
+        file << "Subject: " << subjects[subjectId] << "\n\n";
+        file << "STUDENT ATTENDANCE:\n";
+
+        const uint16_t* counts = attendance.row(subjectId);
+        for (int student : subjectStudents[subjectId]) {
+            file << "Student " << student+1 << ": " << counts[student] << " sessions\n";
+        }
+
+        file << "\nSUMMARY:\n";
+        file << "Total students: " << subjectStudents[subjectId].size() << "\n";
+        file << "Total sessions: " << subjectTotals[subjectId] << "\n";
+    }
+
+    static string studentReportName(int studentId) { return "student_" + to_string(studentId) + "_report.txt"; }
+    string subjectReportName(int subjectId) const { return subjects[subjectId] + "_report.txt"; }
+
+    void saveStudentReport(int studentId) {
+        if (studentId < 1 || studentId > TOTAL_STUDENTS) {
+            cout << "Error: Invalid student ID!\n";
+            return;
+        }
+
+        string filename = studentReportName(studentId);
+        ReportWriter file(filename);
+        renderStudentReport(file, studentId);
+        file.close();
+        cout << "Report saved to: " << filename << "\n";
+    }
+
+    void saveSubjectReport(int subjectId) {
+        if (subjectId < 0 || subjectId >= TOTAL_SUBJECTS) {
+            cout << "Error: Invalid subject ID!\n";
+            return;
+        }
+
+        string filename = subjectReportName(subjectId);
+        ReportWriter file(filename);
+        renderSubjectReport(file, subjectId);
+        file.close();
+        cout << "Report saved to: " << filename << "\n";
+    }
+
+    // The text of the school-wide report
+    void renderSchoolReport(ReportWriter& file) const {
+        file << "SCHOOL WIDE ATTENDANCE REPORT\n\n";
+
+        // Subject summary
+        file << "SUBJECT SUMMARY:\n";
+        for (int subjectId = 0; subjectId < TOTAL_SUBJECTS; subjectId++) {
+            file << subjects[subjectId] << ": " << subjectStudentCount(subjectId) << " students, "
+                 << subjectTotals[subjectId] << " sessions\n";
+        }
+
+        file << "\nSTUDENT SUMMARY:\n";
+        for (int student = 0; student < TOTAL_STUDENTS; student++) {
+            file << "Student " << student+1 << ": " << studentTotals[student] << " total sessions\n";
+        }
+    }
+
+    void saveAllReports() {
+        ReportWriter file("school_report.txt");
+        renderSchoolReport(file);
+        file.close();
+        cout << "School report saved to: school_report.txt\n";
+    }
+
+    // Outcome of generateAllReports()
+    struct ReportRun {
+        size_t students = 0;   // Student reports written
+        size_t subjects = 0;   // Subject reports written
+        size_t unchanged = 0;  // Reports skipped because nothing changed
+        size_t failed = 0;     // Reports that could not be written (retried next run)
+    };
+
+    // Write every student's and subject's report and the school report into
+    // a directory, spread over a thread pool with one reused buffer per
+    // thread. Only reports whose data changed since the last run are
+    // rewritten (all of them on the first run); nothing is printed.
+    ReportRun generateAllReports(const string& directory) {
+        ReportRun run;
+        error_code ignored;
+        filesystem::create_directories(directory, ignored);
+
+        // Jobs: dirty students, then dirty subjects, then the school report
+        vector<int> studentJobs, subjectJobs;
+        for (int w = 0; w < studentWords; w++) {
+            for (uint64_t word = dirtyStudents[w]; word; word &= word - 1) {
+                studentJobs.push_back(w * 64 + lowestBit64(word) + 1);
+            }
+        }
+        for (int subjectId = 0; subjectId < TOTAL_SUBJECTS; subjectId++) {
+            if (dirtySubjects[subjectId]) subjectJobs.push_back(subjectId);
+        }
+        size_t jobCount = studentJobs.size() + subjectJobs.size() + (schoolReportDirty ? 1 : 0);
+        run.unchanged = (TOTAL_STUDENTS - studentJobs.size()) + (TOTAL_SUBJECTS - subjectJobs.size()) +
+                        (schoolReportDirty ? 0 : 1);
+
+        if (!reportPool) reportPool.reset(new ThreadPool());
+        vector<unique_ptr<ReportWriter>> writers(reportPool->size());
+        vector<char> written(jobCount, 0);
+        reportPool->parallelFor(jobCount, [&](size_t job, size_t worker) {
+            string path = directory + "/";
+            if (job < studentJobs.size()) {
+                path += studentReportName(studentJobs[job]);
+            } else if (job < studentJobs.size() + subjectJobs.size()) {
+                path += subjectReportName(subjectJobs[job - studentJobs.size()]);
+            } else {
+                path += "school_report.txt";
+            }
+
+            unique_ptr<ReportWriter>& file = writers[worker];
+            if (!file) {
+                file.reset(new ReportWriter(path));
+            } else {
+                file->reopen(path);
+            }
+            if (!file->isOpen()) return;
+
+            if (job < studentJobs.size()) {
+                renderStudentReport(*file, studentJobs[job]);
+            } else if (job < studentJobs.size() + subjectJobs.size()) {
+                renderSubjectReport(*file, subjectJobs[job - studentJobs.size()]);
+            } else {
+                renderSchoolReport(*file);
+            }
+            file->close();
+            written[job] = file->good();
+        });
+
+        // Clear the flags of what was written; failures stay dirty
+        for (size_t job = 0; job < jobCount; job++) {
+            if (!written[job]) {
+                run.failed++;
+            } else if (job < studentJobs.size()) {
+                int student = studentJobs[job] - 1;
+                dirtyStudents[student / 64] &= ~(uint64_t(1) << (student % 64));
+                run.students++;
+            } else if (job < studentJobs.size() + subjectJobs.size()) {
+                dirtySubjects[subjectJobs[job - studentJobs.size()]] = 0;
+                run.subjects++;
+            } else {
+                schoolReportDirty = false;
+            }
+        }
+        return run;
+    }
+
+    void showSubjects() {
+        ReportWriter out;
+        out << "\n=== SUBJECTS ===\n";
+        for (int i = 0; i < TOTAL_SUBJECTS; i++) {
+            out << i << ". " << subjects[i] << "\n";
+        }
+    }
+
+    void showStudentSubjects(int studentId) {
+        if (studentId < 1 || studentId > TOTAL_STUDENTS) {
+            cout << "Error: Invalid student ID!\n";
+            return;
+        }
+
+        ReportWriter out;
+        out << "\nStudent " << studentId << " takes: ";
+        for (int subjectId : subjectsOf(studentId-1)) {
+            out << subjects[subjectId] << " ";
+        }
+        out << "\n";
+    }
+
+    // Outcome of marking a whole class register
+    struct RegisterSummary {
+        bool validSubject = true;
+        uint32_t marked = 0;       // Counters increased
+        uint32_t notEnrolled = 0;  // Present but not taking the subject (ignored)
+        uint32_t invalidIds = 0;   // Out-of-range student IDs (ID list form only)
+        uint32_t full = 0;         // Counters already at their maximum
+    };
+
+    // Mark everyone present in a subject session at once. present is a
+    // bitset over 0-based students, studentWordCount() words long. Students
+    // who don't take the subject are filtered out with word-wide ANDs
+    // against the subject's enrollment bitset; nothing is printed.
+    RegisterSummary markRegister(int subjectId, const uint64_t* present) {
+        RegisterSummary summary;
+        if (subjectId < 0 || subjectId >= TOTAL_SUBJECTS) {
+            summary.validSubject = false;
+            return summary;
+        }
+
+        const uint64_t* enrolled = &enrollmentBits[subjectId * studentWords];
+        vector<uint64_t> accepted(studentWords);
+        uint32_t acceptedCount = 0, rejectedCount = 0;
+        int firstWord = studentWords, lastWord = -1;  // Words with anyone accepted
+        for (int w = 0; w < studentWords; w++) {
+            accepted[w] = present[w] & enrolled[w];
+            acceptedCount += popcount64(accepted[w]);
+            rejectedCount += popcount64(present[w] & ~enrolled[w]);
+            if (accepted[w]) {
+                firstWord = min(firstWord, w);
+                lastWord = w;
+            }
+        }
+
+        summary.full = attendance.incrementAll(subjectId, accepted.data(), studentTotals.data());
+        summary.marked = acceptedCount - summary.full;
+        summary.notEnrolled = rejectedCount;
+        subjectTotals[subjectId] += summary.marked;
+        if (lastWord >= 0) {
+            // One log record covers the whole span of changed counters
+            int first = firstWord * 64;
+            logCounts(subjectId, first, min((lastWord + 1) * 64, TOTAL_STUDENTS) - first);
+            for (int w = firstWord; w <= lastWord; w++) dirtyStudents[w] |= accepted[w];
+            dirtySubjects[subjectId] = 1;
+            schoolReportDirty = true;
+        }
+        checkAggregates();
+        return summary;
+    }
+
+    // The same with a list of 1-based student IDs (duplicates count once)
+    RegisterSummary markRegister(int subjectId, const vector<int>& presentIds) {
+        vector<uint64_t> present(studentWords, 0);
+        uint32_t invalid = 0;
+        for (int studentId : presentIds) {
+            if (studentId < 1 || studentId > TOTAL_STUDENTS) {
+                invalid++;
+                continue;
+            }
+            present[(studentId-1) / 64] |= uint64_t(1) << ((studentId-1) % 64);
+        }
+        RegisterSummary summary = markRegister(subjectId, present.data());
+        summary.invalidIds = invalid;
+        return summary;
+    }
+
+    // Add sessions to a subject: added[student] more for each 0-based
+    // student, who must take the subject if it is not 0. Counters stop at
+    // their maximum; returns the number of sessions that did not fit.
+    uint64_t addCounts(int subjectId, const uint32_t* added) {
+        uint64_t clamped = 0;
+        int first = -1, last = -1;
+        for (int student = 0; student < TOTAL_STUDENTS; student++) {
+            if (added[student] == 0) continue;
+            uint16_t count = attendance.get(student, subjectId);
+            uint32_t fits = min<uint32_t>(added[student], AttendanceMatrix::MAX_COUNT - count);
+            attendance.set(student, subjectId, static_cast<uint16_t>(count + fits));
+            studentTotals[student] += fits;
+            subjectTotals[subjectId] += fits;
+            clamped += added[student] - fits;
+            markDirty(student, subjectId);
+            if (first < 0) first = student;
+            last = student;
+        }
+        if (first >= 0) logCounts(subjectId, first, last - first + 1);
+        checkAggregates();
+        return clamped;
+    }
+
+    // Record a whole class session. studentIds (1-based) are the students
+    // present, or the ones absent if idsAreAbsent. Every student listed
+    // must take the subject. Present students' counts go up by one.
+    // Returns the session ID, or 0 if nothing was recorded.
+    int recordSession(int subjectId, int day, const vector<int>& studentIds, bool idsAreAbsent = false) {
+        if (subjectId < 0 || subjectId >= TOTAL_SUBJECTS) {
+            cout << "Error: Invalid subject ID!\n";
+            return 0;
+        }
+
+        vector<char> listed(TOTAL_STUDENTS, 0);
+        for (int studentId : studentIds) {
+            if (studentId < 1 || studentId > TOTAL_STUDENTS) {
+                cout << "Error: Invalid student ID " << studentId << "!\n";
+                return 0;
+            }
+            if (!takesSubject(studentId-1, subjectId)) {
+                cout << "Error: Student " << studentId << " doesn't take " << subjects[subjectId] << "!\n";
+                return 0;
+            }
+            listed[studentId-1] = 1;
+        }
+
+        const vector<int>& takers = subjectStudents[subjectId];
+        vector<uint32_t> present;
+        vector<uint64_t> presentBits(studentWords, 0);
+        for (int student : takers) {
+            if (listed[student] != idsAreAbsent) {
+                present.push_back(static_cast<uint32_t>(student));
+                presentBits[student / 64] |= uint64_t(1) << (student % 64);
+            }
+        }
+        markRegister(subjectId, presentBits.data());
+
+        const ClassSession& session = sessionRegister.add(subjectId, day, takers, present);
+        cout << "Recorded session " << session.id << ": " << subjects[subjectId] << " on "
+             << formatDate(day) << ", " << present.size() << "/" << takers.size() << " present\n";
+
+        size_t firstNew = absenceAlerts.size();
+        absenceDetector.onSession(subjectId, day, takers, presentBits.data(), absenceAlerts);
+        for (size_t i = firstNew; i < absenceAlerts.size(); i++) {
+            cout << "ALERT: " << describeAlert(absenceAlerts[i]) << "\n";
+        }
+        return session.id;
+    }
+
+    // "Student 4 attended 3 of the last 10 Physics sessions (limit 75%)"
+    string describeAlert(const AbsenceAlert& alert) const {
+        const AbsenceRules& rules = absenceDetector.settings();
+        string text = "Student " + to_string(alert.student+1) + " attended " + to_string(alert.attended) +
+                      (alert.byDays ? " of " : " of the last ") + to_string(alert.held) + " " +
+                      subjects[alert.subject] + " sessions";
+        if (alert.byDays) text += " in the " + to_string(rules.dayWindow) + " days to " + formatDate(alert.day);
+        return text + " (limit " + to_string(static_cast<int>(rules.minRate * 100 + 0.5)) + "%)";
+    }
+
+    // Students currently below the attendance limit, with their windows,
+    // then the alerts raised so far
+    void showAbsenceAlerts() {
+        const AbsenceRules& rules = absenceDetector.settings();
+        ReportWriter out;
+        out << "\n=== Below " << static_cast<int>(rules.minRate * 100 + 0.5) << "% attendance ===\n";
+        int found = 0;
+        for (int subject = 0; subject < TOTAL_SUBJECTS; subject++) {
+            for (int student : subjectStudents[subject]) {
+                if (!absenceDetector.flagged(student, subject)) continue;
+                AbsenceDetector::Rates r = absenceDetector.rates(student, subject);
+                out << "Student " << student+1 << ", " << subjects[subject] << ": " << r.sessionAttended
+                    << "/" << r.sessionHeld << " last sessions, " << r.dayAttended << "/" << r.dayHeld
+                    << " in " << rules.dayWindow << " days\n";
+                found++;
+            }
+        }
+        if (found == 0) out << "Nobody.\n";
+        out << "Alerts raised: " << absenceAlerts.size() << "\n";
+    }
+
+    // Recompute every pair's windows from the session register and compare
+    // with the detector's. True if they all agree.
+    bool verifyAbsenceWindows() const {
+        const AbsenceRules& rules = absenceDetector.settings();
+        bool ok = true;
+        for (int subject = 0; subject < TOTAL_SUBJECTS; subject++) {
+            vector<const ClassSession*> held = sessionRegister.between(subject, INT32_MIN, INT32_MAX);
+            if (held.empty()) continue;
+            size_t sessionWindow = min<size_t>(held.size(), rules.sessionWindow);
+            size_t dayWindow = 0;
+            int lastDay = held.back()->day;
+            while (dayWindow < held.size() && dayWindow < AbsenceDetector::HISTORY &&
+                   held[held.size() - 1 - dayWindow]->day > lastDay - rules.dayWindow) {
+                dayWindow++;
+            }
+
+            for (int student : subjectStudents[subject]) {
+                uint32_t bySessions = 0, byDays = 0;
+                for (size_t back = 0; back < max(sessionWindow, dayWindow); back++) {
+                    bool present = held[held.size() - 1 - back]->wasPresent(student);
+                    if (back < sessionWindow) bySessions += present;
+                    if (back < dayWindow) byDays += present;
+                }
+                AbsenceDetector::Rates r = absenceDetector.rates(student, subject);
+                if (r.sessionAttended != bySessions || r.sessionHeld != sessionWindow ||
+                    r.dayAttended != byDays || r.dayHeld != dayWindow) {
+                    cout << "Mismatch: Student " << student+1 << " " << subjects[subject] << " windows "
+                         << r.sessionAttended << "/" << r.sessionHeld << ", " << r.dayAttended << "/"
+                         << r.dayHeld << ", recounted " << bySessions << "/" << sessionWindow << ", "
+                         << byDays << "/" << dayWindow << "\n";
+                    ok = false;
+                }
+            }
+        }
+        return ok;
+    }
+
+    // List who missed the sessions held on a date (subjectId -1: all subjects)
+    void showAbsentees(int day, int subjectId = -1) {
+        if (subjectId < -1 || subjectId >= TOTAL_SUBJECTS) {
+            cout << "Error: Invalid subject ID!\n";
+            return;
+        }
+
+        ReportWriter out;
+        out << "\n=== Absent on " << formatDate(day) << " ===\n";
+        int sessionsFound = 0;
+        for (int subject = 0; subject < TOTAL_SUBJECTS; subject++) {
+            if (subjectId != -1 && subject != subjectId) continue;
+
+            for (const ClassSession* session : sessionRegister.between(subject, day, day)) {
+                sessionsFound++;
+                out << subjects[subject] << " (session " << session->id << "): ";
+                uint32_t absent = session->enrolled - session->presentCount();
+                if (session->storesAbsent) {
+                    session->students.forEach([&](uint32_t student) { out << student+1 << " "; });
+                } else {
+                    for (int student : subjectStudents[subject]) {
+                        if (!session->students.contains(student)) out << student+1 << " ";
+                    }
+                }
+                out << (absent == 0 ? "nobody" : "") << "\n";
+            }
+        }
+        if (sessionsFound == 0) out << "No sessions recorded on this date.\n";
+    }
+
+    // Attendance percentages between two dates (inclusive): per subject for
+    // one student, or for the whole school when studentId is 0
+    void showAttendancePercentage(int studentId, int fromDay, int toDay) {
+        if (studentId < 0 || studentId > TOTAL_STUDENTS) {
+            cout << "Error: Invalid student ID!\n";
+            return;
+        }
+
+        ReportWriter out;
+        out << "\n=== Attendance " << formatDate(fromDay) << " to " << formatDate(toDay) << " ("
+            << (studentId == 0 ? string("whole school") : "Student " + to_string(studentId)) << ") ===\n";
+
+        vector<int> subjectList;
+        if (studentId == 0) {
+            for (int subject = 0; subject < TOTAL_SUBJECTS; subject++) subjectList.push_back(subject);
+        } else {
+            subjectList = subjectsOf(studentId-1);
+        }
+
+        uint64_t allAttended = 0, allPossible = 0;
+        for (int subject : subjectList) {
+            uint64_t attended = 0, possible = 0;
+            vector<const ClassSession*> held = sessionRegister.between(subject, fromDay, toDay);
+            for (const ClassSession* session : held) {
+                if (studentId == 0) {
+                    attended += session->presentCount();
+                    possible += session->enrolled;
+                } else {
+                    attended += session->wasPresent(studentId-1);
+                    possible++;
+                }
+            }
+            if (held.empty()) continue;
+
+            out.padRight(subjects[subject], 15) << attended << "/" << possible << " (";
+            out.fixed(100.0 * attended / possible, 1) << "%) over " << held.size() << " sessions\n";
+            allAttended += attended;
+            allPossible += possible;
+        }
+
+        if (allPossible == 0) {
+            out << "No sessions recorded in this period.\n";
+            return;
+        }
+        out << "Overall: ";
+        out.fixed(100.0 * allAttended / allPossible, 1) << "%\n";
+    }
+
+    // Recompute every total from the counters and compare with the kept
+    // ones, reporting each mismatch. True if they all agree.
+    bool verifyAggregates() const {
+        bool ok = true;
+        vector<uint64_t> perStudent(TOTAL_STUDENTS, 0);
+        for (int subjectId = 0; subjectId < TOTAL_SUBJECTS; subjectId++) {
+            const uint16_t* counts = attendance.row(subjectId);
+            uint64_t total = 0;
+            for (int student = 0; student < TOTAL_STUDENTS; student++) {
+                total += counts[student];
+                perStudent[student] += counts[student];
+            }
+            if (total != subjectTotals[subjectId]) {
+                cout << "Mismatch: " << subjects[subjectId] << " total " << subjectTotals[subjectId]
+                     << ", counted " << total << "\n";
+                ok = false;
+            }
+
+            int takers = 0;
+            for (int student = 0; student < TOTAL_STUDENTS; student++) {
+                takers += takesSubject(student, subjectId);
+            }
+            if (takers != subjectStudentCount(subjectId)) {
+                cout << "Mismatch: " << subjects[subjectId] << " has " << subjectStudentCount(subjectId)
+                     << " students listed, " << takers << " take it\n";
+                ok = false;
+            }
+        }
+        for (int student = 0; student < TOTAL_STUDENTS; student++) {
+            if (perStudent[student] != studentTotals[student]) {
+                cout << "Mismatch: Student " << student+1 << " total " << studentTotals[student]
+                     << ", counted " << perStudent[student] << "\n";
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    size_t sessionCount() const { return sessionRegister.size(); }
+    size_t sessionBytes() const { return sessionRegister.bytes(); }
+};
+
+// ===== Concurrent ingestion =====
+//
+// Lets many classroom terminals submit marks and registers at once without
+// a global lock. Submissions go through a lock-free queue to a few applier
+// threads, and each applier adds into its own shard of counters, so no two
+// threads ever write the same memory. Reads merge the school's counters
+// with every shard.
+//
+// Each shard is guarded by a sequence lock: its applier makes the sequence
+// odd while applying one submission and even again afterwards, and a reader
+// that saw an odd or changed sequence reads the shard again. A snapshot thus
+// holds each submission entirely or not at all (a register is never half
+// counted), and its totals always match each other.
+//
+// An applier that finds the queue empty keeps polling for a short while
+// (submissions tend to come in bursts), then sleeps until a submitter wakes
+// it, so an idle school does not keep a core busy per applier.
+//
+// The school must not be changed while ingestion runs; fold() adds the
+// shards into it once stop() has returned.
+class ConcurrentAttendance {
+public:
+    struct Snapshot {
+        vector<uint64_t> subjectTotals;
+        vector<uint64_t> studentTotals;  // 0-based students
+        uint64_t marks = 0;              // Counters increased since ingestion started
+    };
+
+    ConcurrentAttendance(SchoolAttendance& school, int applierCount, size_t queueCapacity = 4096)
+        : school(school), queue(queueCapacity) {
+        for (int i = 0; i < max(1, applierCount); i++) {
+            shards.emplace_back(new Shard(school.studentCount(), school.subjectCount()));
+        }
+        for (auto& shard : shards) {
+            Shard* own = shard.get();
+            appliers.emplace_back([this, own]() { runApplier(*own); });
+        }
+    }
+
+    ConcurrentAttendance(const ConcurrentAttendance&) = delete;
+    ConcurrentAttendance& operator=(const ConcurrentAttendance&) = delete;
+    ~ConcurrentAttendance() { stop(); }
+
+    // Queue one mark (1-based student). Safe to call from many threads;
+    // waits while the queue is full.
+    void submitMark(int studentId, int subjectId) {
+        Submission item;
+        item.subject = subjectId;
+        item.student = studentId - 1;
+        push(item);
+    }
+
+    // Queue a whole register: present is a bitset over 0-based students,
+    // studentWordCount() words long. Safe to call from many threads.
+    void submitRegister(int subjectId, vector<uint64_t> present) {
+        Submission item;
+        item.subject = subjectId;
+        item.present = move(present);
+        push(item);
+    }
+
+    // Apply everything already queued, then end the applier threads. Call
+    // once every submitting thread has finished.
+    void stop() {
+        stopping.store(true, memory_order_release);
+        {
+            lock_guard<mutex> lock(idleLock);
+            idle.notify_all();
+        }
+        for (thread& applier : appliers) applier.join();
+        appliers.clear();
+    }
+
+    // Totals over the school's counters plus every shard
+    Snapshot snapshot() const {
+        Snapshot result;
+        result.subjectTotals.resize(school.subjectCount());
+        result.studentTotals.resize(school.studentCount());
+        for (int subject = 0; subject < school.subjectCount(); subject++) {
+            result.subjectTotals[subject] = school.subjectTotal(subject);
+        }
+        for (int student = 0; student < school.studentCount(); student++) {
+            result.studentTotals[student] = school.studentTotal(student+1);
+        }
+
+        vector<uint64_t> subjectPart, studentPart;
+        for (const auto& shard : shards) {
+            uint64_t marks = 0;
+            uint32_t before;
+            do {
+                before = shard->sequence.load(memory_order_acquire);
+                if (before & 1) {
+                    this_thread::yield();  // Mid-submission
+                    continue;
+                }
+                copyRelaxed(shard->subjectTotals, subjectPart);
+                copyRelaxed(shard->studentTotals, studentPart);
+                marks = shard->marks.load(memory_order_relaxed);
+                atomic_thread_fence(memory_order_acquire);
+            } while ((before & 1) || shard->sequence.load(memory_order_relaxed) != before);
+
+            for (size_t i = 0; i < subjectPart.size(); i++) result.subjectTotals[i] += subjectPart[i];
+            for (size_t i = 0; i < studentPart.size(); i++) result.studentTotals[i] += studentPart[i];
+            result.marks += marks;
+        }
+        return result;
+    }
+
+    // One student's sessions in a subject so far (1-based student)
+    uint64_t count(int studentId, int subjectId) const {
+        uint64_t total = school.attendanceCount(studentId, subjectId);
+        size_t cell = static_cast<size_t>(subjectId) * school.studentCount() + studentId - 1;
+        for (const auto& shard : shards) total += shard->counts[cell].load(memory_order_relaxed);
+        return total;
+    }
+
+    // Submissions refused: invalid IDs, or students not taking the subject
+    uint64_t rejected() const {
+        uint64_t total = 0;
+        for (const auto& shard : shards) total += shard->rejected.load(memory_order_relaxed);
+        return total;
+    }
+
+    // Add the shards into the school and empty them (only after stop()).
+    // Returns the sessions that did not fit in the school's counters.
+    uint64_t fold() {
+        const int students = school.studentCount();
+        vector<uint32_t> added(students);
+        uint64_t clamped = 0;
+        for (int subject = 0; subject < school.subjectCount(); subject++) {
+            fill(added.begin(), added.end(), 0);
+            for (const auto& shard : shards) {
+                const atomic<uint32_t>* counts = &shard->counts[static_cast<size_t>(subject) * students];
+                for (int student = 0; student < students; student++) {
+                    added[student] += counts[student].load(memory_order_relaxed);
+                }
+            }
+            clamped += school.addCounts(subject, added.data());
+        }
+        for (auto& shard : shards) shard->clear();
+        return clamped;
+    }
+
+private:
+    struct Submission {
+        int subject = 0;
+        int student = -1;          // 0-based; -1 for a register
+        vector<uint64_t> present;  // Register bitset
+    };
+
+    // Counters added by one applier. Only that applier writes them, so the
+    // atomics are plain loads and stores; they are atomic only so that
+    // readers may look at them concurrently.
+    struct alignas(64) Shard {
+        atomic<uint32_t> sequence{0};  // Odd while a submission is being applied
+        vector<atomic<uint32_t>> counts;  // Subject-major, no padding
+        vector<atomic<uint64_t>> subjectTotals;
+        vector<atomic<uint64_t>> studentTotals;
+        atomic<uint64_t> marks{0};
+        atomic<uint64_t> rejected{0};
+
+        Shard(int students, int subjects)
+            : counts(static_cast<size_t>(students) * subjects), subjectTotals(subjects),
+              studentTotals(students) {}
+
+        void clear() {
+            for (auto& c : counts) c.store(0, memory_order_relaxed);
+            for (auto& t : subjectTotals) t.store(0, memory_order_relaxed);
+            for (auto& t : studentTotals) t.store(0, memory_order_relaxed);
+            marks.store(0, memory_order_relaxed);
+        }
+    };
+
+    template <typename T>
+    static void bump(atomic<T>& value, T by = 1) {
+        value.store(value.load(memory_order_relaxed) + by, memory_order_relaxed);
+    }
+
+    template <typename T>
+    static void copyRelaxed(const vector<atomic<T>>& from, vector<uint64_t>& to) {
+        to.resize(from.size());
+        for (size_t i = 0; i < from.size(); i++) to[i] = from[i].load(memory_order_relaxed);
+    }
+
+    // Empty polls before an applier goes to sleep
+    static const int IDLE_SPINS = 64;
+
+    void push(Submission& item) {
+        while (!queue.tryPush(item)) this_thread::yield();
+
+        // Pairs with the fence in runApplier: either the applier sees the
+        // item, or this sees the applier asleep and wakes it
+        atomic_thread_fence(memory_order_seq_cst);
+        if (sleepers.load(memory_order_relaxed) > 0) {
+            lock_guard<mutex> lock(idleLock);
+            idle.notify_one();
+        }
+    }
+
+    void runApplier(Shard& shard) {
+        Submission item;
+        int spins = 0;
+        while (true) {
+            if (queue.tryPop(item)) {
+                apply(shard, item);
+                spins = 0;
+            } else if (stopping.load(memory_order_acquire)) {
+                if (!queue.tryPop(item)) return;  // Nothing came in before stop()
+                apply(shard, item);
+            } else if (++spins < IDLE_SPINS) {
+                this_thread::yield();
+            } else {
+                unique_lock<mutex> lock(idleLock);
+                sleepers.fetch_add(1, memory_order_relaxed);
+                atomic_thread_fence(memory_order_seq_cst);
+                if (queue.tryPop(item)) {
+                    sleepers.fetch_sub(1, memory_order_relaxed);
+                    lock.unlock();
+                    apply(shard, item);
+                } else {
+                    if (!stopping.load(memory_order_acquire)) idle.wait(lock);
+                    sleepers.fetch_sub(1, memory_order_relaxed);
+                }
+                spins = 0;
+            }
+        }
+    }
+
+    void apply(Shard& shard, const Submission& item) {
+        const int students = school.studentCount();
+        bool validSubject = item.subject >= 0 && item.subject < school.subjectCount();
+        const uint64_t* enrolled = validSubject ? school.enrollmentRow(item.subject) : nullptr;
+
+        if (item.student >= 0) {
+            if (!validSubject || item.student >= students ||
+                !((enrolled[item.student / 64] >> (item.student % 64)) & 1)) {
+                bump<uint64_t>(shard.rejected);
+                return;
+            }
+        } else if (!validSubject || item.present.size() != static_cast<size_t>(school.studentWordCount())) {
+            bump<uint64_t>(shard.rejected);
+            return;
+        }
+
+        uint32_t before = shard.sequence.load(memory_order_relaxed);
+        shard.sequence.store(before + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+
+        atomic<uint32_t>* counts = &shard.counts[static_cast<size_t>(item.subject) * students];
+        uint64_t marked = 0;
+        if (item.student >= 0) {
+            bump(counts[item.student]);
+            bump<uint64_t>(shard.studentTotals[item.student]);
+            marked = 1;
+        } else {
+            for (size_t w = 0; w < item.present.size(); w++) {
+                bump<uint64_t>(shard.rejected, popcount64(item.present[w] & ~enrolled[w]));
+                for (uint64_t word = item.present[w] & enrolled[w]; word; word &= word - 1) {
+                    int student = static_cast<int>(w * 64) + lowestBit64(word);
+                    bump(counts[student]);
+                    bump<uint64_t>(shard.studentTotals[student]);
+                    marked++;
+                }
+            }
+        }
+        bump(shard.subjectTotals[item.subject], marked);
+        bump(shard.marks, marked);
+
+        shard.sequence.store(before + 2, memory_order_release);
+    }
+
+    SchoolAttendance& school;
+    MpmcQueue<Submission> queue;
+    vector<unique_ptr<Shard>> shards;
+    vector<thread> appliers;
+    atomic<bool> stopping{false};
+
+    mutex idleLock;
+    condition_variable idle;  // A submission came in, or stop() was called
+    atomic<int> sleepers{0};  // Appliers waiting on idle
+};
+
+// Read a date until it is valid
+int readDate(const string& prompt) {
+    string text;
+    int day;
+    while (true) {
+        cout << prompt;
+        if (!(cin >> text)) return 0;  // Input closed
+        if (parseDate(text, day)) return day;
+        cout << "Invalid date, use YYYY-MM-DD.\n";
+    }
+}
+
+// Benchmark.cpp includes this file with SCHOOL_NO_MAIN defined
+#ifndef SCHOOL_NO_MAIN
+// Self-check of the kept totals: random single marks, class registers and
+// recorded sessions, then a full recount. Returns the process exit code.
+int runAggregateCheck(int studentTotal) {
+    SchoolAttendance school(studentTotal);
+    mt19937 rng(2024);
+    const int ROUNDS = 200;
+
+    streambuf* console = cout.rdbuf(nullptr);  // Silence per-mark messages
+    for (int round = 0; round < ROUNDS; round++) {
+        int subjectId = rng() % school.subjectCount();
+        for (int i = 0; i < 50; i++) {
+            school.markAttendance(rng() % school.studentCount() + 1, rng() % school.subjectCount());
+        }
+
+        vector<uint64_t> present(school.studentWordCount());
+        for (uint64_t& word : present) word = (uint64_t(rng()) << 32) | rng();
+        school.markRegister(subjectId, present.data());
+
+        vector<int> ids;
+        for (int i = 0; i < 20; i++) ids.push_back(rng() % (school.studentCount() + 5));
+        school.markRegister(subjectId, ids);
+
+        // A dated session, two or three a day; some students miss more
+        // often than others so the absence windows have alerts to raise
+        vector<int> absent;
+        const uint64_t* takers = school.enrollmentRow(subjectId);
+        for (int student = 0; student < school.studentCount(); student++) {
+            bool takes = (takers[student / 64] >> (student % 64)) & 1;
+            if (takes && static_cast<int>(rng() % 100) < (student % 4) * 15) absent.push_back(student+1);
+        }
+        school.recordSession(subjectId, daysFromCivil(2026, 1, 5) + round * 2 / 5, absent, true);
+    }
+    cout.rdbuf(console);
+    cout.clear();
+
+    bool ok = school.verifyAggregates();
+    cout << (ok ? "PASS: all attendance totals match the counters\n"
+                : "FAIL: attendance totals are out of step\n");
+    bool windowsOk = school.verifyAbsenceWindows();
+    cout << (windowsOk ? "PASS: absence windows match the session register\n"
+                       : "FAIL: absence windows are out of step\n");
+    return ok && windowsOk ? 0 : 1;
+}
+
+// Concurrent ingestion stress test: producer threads submit random marks
+// (some invalid) and registers while a reader takes snapshots, then checks:
+//   - every snapshot's subject and student totals agree with its mark count
+//   - the mark count never goes backwards between snapshots
+//   - the final counts equal what the producers expect to be accepted
+//   - after fold() the school's counters and totals still match
+// Returns the process exit code.
+int runIngestStress(int threadCount) {
+    const int STUDENTS = 2000;
+    const int SUBMISSIONS_PER_THREAD = 50000;
+    const int REGISTER_EVERY = 20;  // One submission in this many is a register
+
+    streambuf* console = cout.rdbuf(nullptr);
+    SchoolAttendance school(STUDENTS);
+    cout.rdbuf(console);
+    cout.clear();
+    const int subjects = school.subjectCount();
+    const int appliers = max(1, threadCount / 2);
+
+    cout << "Ingest stress test: " << threadCount << " producers, " << appliers << " appliers, "
+         << SUBMISSIONS_PER_THREAD << " submissions each, " << STUDENTS << " students\n";
+
+    auto enrolled = [&](int student, int subject) {
+        return (school.enrollmentRow(subject)[student / 64] >> (student % 64)) & 1;
+    };
+
+    // expected[t][subject * STUDENTS + student]: marks producer t expects accepted
+    vector<vector<uint32_t>> expected(threadCount, vector<uint32_t>(static_cast<size_t>(subjects) * STUDENTS, 0));
+    size_t failures = 0;
+    atomic<bool> producing{true};
+    uint64_t snapshots = 0;
+
+    auto started = chrono::steady_clock::now();
+    {
+        ConcurrentAttendance ingest(school, appliers);
+
+        thread reader([&]() {
+            uint64_t lastMarks = 0;
+            while (producing.load(memory_order_acquire)) {
+                ConcurrentAttendance::Snapshot snap = ingest.snapshot();
+                uint64_t bySubject = 0, byStudent = 0;
+                for (uint64_t total : snap.subjectTotals) bySubject += total;
+                for (uint64_t total : snap.studentTotals) byStudent += total;
+                if (bySubject != snap.marks || byStudent != snap.marks || snap.marks < lastMarks) {
+                    cout << "FAIL: torn snapshot: " << bySubject << " by subject, " << byStudent
+                         << " by student, " << snap.marks << " marks (previous " << lastMarks << ")\n";
+                    failures++;
+                    return;
+                }
+                lastMarks = snap.marks;
+                snapshots++;
+            }
+        });
+
+        vector<thread> producers;
+        for (int t = 0; t < threadCount; t++) {
+            producers.emplace_back([&, t]() {
+                mt19937 rng(500 + t);
+                vector<uint32_t>& mine = expected[t];
+                for (int i = 0; i < SUBMISSIONS_PER_THREAD; i++) {
+                    int subject = rng() % subjects;
+                    if (i % REGISTER_EVERY == 0) {
+                        vector<uint64_t> present(school.studentWordCount(), 0);
+                        for (int student = 0; student < STUDENTS; student++) {
+                            if (rng() % 10 == 0) continue;  // Absent
+                            present[student / 64] |= uint64_t(1) << (student % 64);
+                            if (enrolled(student, subject)) mine[subject * STUDENTS + student]++;
+                        }
+                        ingest.submitRegister(subject, move(present));
+                    } else {
+                        int studentId = rng() % (STUDENTS + 10) + 1;  // A few are out of range
+                        if (studentId <= STUDENTS && enrolled(studentId-1, subject)) {
+                            mine[subject * STUDENTS + studentId-1]++;
+                        }
+                        ingest.submitMark(studentId, subject);
+                    }
+                }
+            });
+        }
+        for (thread& producer : producers) producer.join();
+        ingest.stop();
+        producing.store(false, memory_order_release);
+        reader.join();
+
+        for (int subject = 0; subject < subjects; subject++) {
+            for (int student = 0; student < STUDENTS; student++) {
+                uint64_t want = 0;
+                for (int t = 0; t < threadCount; t++) want += expected[t][subject * STUDENTS + student];
+                if (ingest.count(student+1, subject) != want && failures++ < 10) {
+                    cout << "FAIL: Student " << student+1 << " subject " << subject << " has "
+                         << ingest.count(student+1, subject) << " sessions, expected " << want << "\n";
+                }
+            }
+        }
+
+        streambuf* quiet = cout.rdbuf(nullptr);
+        uint64_t clamped = ingest.fold();
+        cout.rdbuf(quiet);
+        cout.clear();
+        if (clamped != 0) {
+            cout << "FAIL: " << clamped << " sessions did not fit the counters\n";
+            failures++;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+    if (!school.verifyAggregates()) failures++;
+
+    uint64_t marks = 0;
+    for (int subject = 0; subject < subjects; subject++) marks += school.subjectTotal(subject);
+    double submissions = double(threadCount) * SUBMISSIONS_PER_THREAD;
+    cout << marks << " marks from " << static_cast<long long>(submissions) << " submissions in " << seconds
+         << " s (" << static_cast<long long>(submissions / max(seconds, 1e-9)) << " submissions/s, "
+         << snapshots << " snapshots taken)\n";
+    cout << (failures == 0 ? "PASS: ingestion matches the submissions\n" : "FAIL: ingestion lost or tore marks\n");
+    return failures == 0 ? 0 : 1;
+}
+
+const string ATTENDANCE_FILE = "attendance.dat";
+const string ATTENDANCE_LOG = "attendance.log";
+const string REPORT_DIRECTORY = "attendance_reports";
+
+// Usage: attendance [students] [subjects]
+//        attendance --verify [students]          (check the kept totals and exit)
+//        attendance --stress-ingest [threads]    (concurrent ingestion test)
+// The size only matters the first time: afterwards attendance.dat decides.
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && string(argv[1]) == "--verify") {
+        return runAggregateCheck(argc >= 3 ? max(1, atoi(argv[2])) : SchoolAttendance::DEFAULT_STUDENTS);
+    }
+    if (argc >= 2 && string(argv[1]) == "--stress-ingest") {
+        return runIngestStress(argc >= 3 ? max(1, atoi(argv[2])) : 8);
+    }
+
+    int studentTotal = argc >= 2 ? atoi(argv[1]) : SchoolAttendance::DEFAULT_STUDENTS;
+    int subjectTotal = argc >= 3 ? atoi(argv[2]) : SchoolAttendance::NAMED_SUBJECTS;
+    if (studentTotal < 1 || subjectTotal < 1) {
+        cout << "Usage: " << argv[0] << " [students] [subjects]\n";
+        return 1;
+    }
+
+    int storedStudents, storedSubjects;
+    if (AttendanceStore::readSize(ATTENDANCE_FILE, storedStudents, storedSubjects)) {
+        if (argc >= 2 && (storedStudents != studentTotal ||
+                          storedSubjects != max(subjectTotal, SchoolAttendance::NAMED_SUBJECTS))) {
+            cout << "Note: " << ATTENDANCE_FILE << " is for " << storedStudents << " students and "
+                 << storedSubjects << " subjects; delete it to start a different school.\n";
+        }
+        studentTotal = storedStudents;
+        subjectTotal = storedSubjects;
+    }
+
+    SchoolAttendance school(studentTotal, subjectTotal, ATTENDANCE_FILE, ATTENDANCE_LOG);
+    int choice;
+    string studentPrompt = "Enter student ID (1-" + to_string(school.studentCount()) + "): ";
+    string subjectPrompt = "Enter subject ID (0-" + to_string(school.subjectCount() - 1) + "): ";
+
+    cout << "=== SCHOOL ATTENDANCE SYSTEM ===\n";
+    cout << school.studentCount() << " Students | " << school.subjectCount() << " Subjects\n\n";
+
+    do {
+        school.syncStore();  // Everything marked so far survives a crash from here on
+
+        cout << "\n=== MAIN MENU ===\n";
+        cout << "1. Mark Attendance\n";
+        cout << "2. View Student Attendance\n";
+        cout << "3. View Subject Attendance\n";
+        cout << "4. Save Student Report\n";
+        cout << "5. Save Subject Report\n";
+        cout << "6. Save All Reports\n";
+        cout << "7. Show Subjects List\n";
+        cout << "8. Show Student's Subjects\n";
+        cout << "9. Record Class Session\n";
+        cout << "10. Show Absentees for a Date\n";
+        cout << "11. Attendance Percentage for a Period\n";
+        cout << "12. Generate All Reports\n";
+        cout << "13. Show Absence Alerts\n";
+        cout << "14. Exit\n";
+        cout << "Choose option: ";
+        cin >> choice;
+
+        switch (choice) {
+            case 1: {
+                int studentId, subjectId;
+                cout << studentPrompt;
+                cin >> studentId;
+                cout << subjectPrompt;
+                cin >> subjectId;
+                school.markAttendance(studentId, subjectId);
+                break;
+            }
+            case 2: {
+                int studentId;
+                cout << studentPrompt;
+                cin >> studentId;
+                school.showStudentAttendance(studentId);
+                break;
+            }
+            case 3: {
+                int subjectId;
+                cout << subjectPrompt;
+                cin >> subjectId;
+                cin.ignore();
+                school.showSubjectAttendance(subjectId,
+                                             RowRange::prompt(school.subjectStudentCount(subjectId)));
+                break;
+            }
+            case 4: {
+                int studentId;
+                cout << studentPrompt;
+                cin >> studentId;
+                school.saveStudentReport(studentId);
+                break;
+            }
+            case 5: {
+                int subjectId;
+                cout << subjectPrompt;
+                cin >> subjectId;
+                school.saveSubjectReport(subjectId);
+                break;
+            }
+            case 6:
+                school.saveAllReports();
+                break;
+            case 7:
+                school.showSubjects();
+                break;
+            case 8: {
+                int studentId;
+                cout << studentPrompt;
+                cin >> studentId;
+                school.showStudentSubjects(studentId);
+                break;
+            }
+            case 9: {
+                int subjectId;
+                cout << subjectPrompt;
+                cin >> subjectId;
+                int day = readDate("Enter date (YYYY-MM-DD): ");
+                cin.ignore();
+
+                string line;
+                cout << "Enter absent student IDs (space separated, Enter if none): ";
+                getline(cin, line);
+                vector<int> absent;
+                istringstream ids(line);
+                int studentId;
+                while (ids >> studentId) absent.push_back(studentId);
+                school.recordSession(subjectId, day, absent, true);
+                break;
+            }
+            case 10: {
+                int day = readDate("Enter date (YYYY-MM-DD): ");
+                int subjectId;
+                cout << "Enter subject ID (-1 for all): ";
+                cin >> subjectId;
+                school.showAbsentees(day, subjectId);
+                break;
+            }
+            case 11: {
+                int studentId;
+                cout << "Enter student ID (0 for whole school): ";
+                cin >> studentId;
+                int fromDay = readDate("From date (YYYY-MM-DD): ");
+                int toDay = readDate("To date (YYYY-MM-DD): ");
+                school.showAttendancePercentage(studentId, fromDay, toDay);
+                break;
+            }
+            case 12: {
+                SchoolAttendance::ReportRun run = school.generateAllReports(REPORT_DIRECTORY);
+                cout << "Reports in " << REPORT_DIRECTORY << "/: " << run.students << " student and "
+                     << run.subjects << " subject reports written, " << run.unchanged << " unchanged\n";
+                if (run.failed > 0) cout << "Error: " << run.failed << " reports could not be written!\n";
+                break;
+            }
+            case 13:
+                school.showAbsenceAlerts();
+                break;
+            case 14:
+                school.saveStore();
+                cout << "Goodbye!\n";
+                break;
+            default:
+                cout << "Invalid choice! Try again.\n";
+        }
+    } while (choice != 14);
+
+    return 0;
+}
+#endif
@@ -0,0 +1,763 @@
+// Benchmarks for the core operations of the three programs, on
+// deterministic synthetic data (SyntheticData.h) at several sizes.
+//
+//   g++ -std=c++17 -O2 -pthread Benchmark.cpp -o benchmark
+//   ./benchmark [--sizes 1000,10000,50000] [--ops 20000] [--seed 42]
+//   ./benchmark --generate <file> <students> <courses> <density> [seed]
+//
+// The programs are compiled in with SCHOOL_NO_MAIN, so this measures exactly
+// the code they run. Their console output is discarded while timing. The
+// benchmark works in a scratch directory (school_benchmark/) so the data
+// files of a real installation are never touched.
+#define SCHOOL_NO_MAIN
+#include "StudentEnrollment.cpp"
+#include "Grade management.cpp"
+#include "Attendance tracking.cpp"
+#include "SyntheticData.h"
+
+#include <filesystem>
+#include <sstream>
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#define dup _dup
+#define dup2 _dup2
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+// Silences cout and stdout (ReportWriter writes there directly) while alive
+class QuietOutput {
+public:
+    QuietOutput() {
+        cout.flush();
+        fflush(stdout);
+        savedBuffer = cout.rdbuf(&discard);
+        savedStdout = dup(1);
+        int nullFd = ::open(NULL_DEVICE, O_WRONLY);
+        if (nullFd >= 0) {
+            dup2(nullFd, 1);
+            ::close(nullFd);
+        }
+    }
+
+    ~QuietOutput() {
+        fflush(stdout);
+        if (savedStdout >= 0) {
+            dup2(savedStdout, 1);
+            ::close(savedStdout);
+        }
+        cout.rdbuf(savedBuffer);
+    }
+
+private:
+    struct NullBuffer : streambuf {
+        int overflow(int c) override { return c; }
+        streamsize xsputn(const char*, streamsize n) override { return n; }
+    } discard;
+    streambuf* savedBuffer;
+    int savedStdout;
+};
+
+// Hand a result to the outside world, so the compiler can neither drop the
+// call that produced it nor move it out of the timed region
+volatile uintptr_t benchmarkSink;
+template <typename T>
+void keep(const T* result) {
+    benchmarkSink = reinterpret_cast<uintptr_t>(result);
+}
+
+void keep(int result) {
+    benchmarkSink = static_cast<uintptr_t>(result);
+}
+
+// Per-operation latencies of one benchmark, in nanoseconds
+class Latencies {
+public:
+    explicit Latencies(size_t expected = 0) { samples.reserve(expected); }
+
+    // Time one call of op
+    template <typename Op>
+    void measure(Op&& op) {
+        auto start = chrono::steady_clock::now();
+        op();
+        auto elapsed = chrono::steady_clock::now() - start;
+        samples.push_back(chrono::duration<double, nano>(elapsed).count());
+    }
+
+    // One row of the results table
+    void report(const string& operation, size_t size) {
+        if (samples.empty()) return;
+        double seconds = totalSeconds();
+        sort(samples.begin(), samples.end());
+
+        ReportWriter out;
+        out.padRight(operation, 32).padRight(to_string(size), 9);
+        out.padRight(to_string(samples.size()), 9);
+        out.padRight(samples.size() / seconds, 0, 14);
+        out.padRight(percentile(0.50) / 1000, 2, 11).padRight(percentile(0.90) / 1000, 2, 11);
+        out.padRight(percentile(0.99) / 1000, 2, 11).fixed(samples.back() / 1000, 2) << "\n";
+    }
+
+    static void header() {
+        ReportWriter out;
+        out.padRight("OPERATION", 32).padRight("SIZE", 9).padRight("OPS", 9);
+        out.padRight("OPS/SEC", 14).padRight("P50 us", 11).padRight("P90 us", 11);
+        out.padRight("P99 us", 11) << "MAX us\n";
+        out << string(108, '-') << "\n";
+    }
+
+    double totalSeconds() const {
+        double total = 0;
+        for (double ns : samples) total += ns;
+        return total / 1e9;
+    }
+
+private:
+    double percentile(double p) const {
+        size_t rank = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+        return samples[rank];
+    }
+
+    vector<double> samples;
+};
+
+struct BenchmarkOptions {
+    vector<size_t> sizes = {1000, 10000, 50000};
+    size_t ops = 20000;  // Operations per cheap benchmark
+    uint64_t seed = 42;
+};
+
+// ===== Student enrollment =====
+void benchmarkEnrollment(size_t size, const BenchmarkOptions& options) {
+    SyntheticConfig config;
+    config.students = size;
+    config.courses = max<size_t>(20, size / 50);
+    config.seed = options.seed;
+    SyntheticData data(config);
+
+    resetData();
+    remove(SNAPSHOT_FILE.c_str());
+    remove(JOURNAL_FILE.c_str());
+    if (!data.writeEnrollmentText(DATA_FILE)) {
+        cout << "Error: Could not write " << DATA_FILE << "\n";
+        return;
+    }
+
+    const int LOAD_RUNS = 5;
+    Latencies loadText;
+    for (int run = 0; run < LOAD_RUNS; ++run) {
+        resetData();
+        remove(JOURNAL_FILE.c_str());
+        QuietOutput quiet;
+        loadText.measure([] { loadData(); });
+    }
+    loadText.report("loadData (text)", size);
+
+    Latencies find(options.ops);
+    vector<string> lookups;
+    for (size_t i = 0; i < options.ops; ++i) {
+        lookups.push_back(SyntheticData::studentID(data.below(size)));
+    }
+    for (const string& id : lookups) {
+        find.measure([&] { keep(findStudent(id)); });
+    }
+    find.report("findStudent", size);
+
+    // Enrollment requests, journaled like the menu does. Most are new
+    // enrollments; some hit a course the student already has.
+    Latencies enroll(options.ops);
+    vector<pair<string, string>> requests;
+    for (size_t i = 0; i < options.ops; ++i) {
+        requests.emplace_back(SyntheticData::studentID(data.below(size)),
+                              SyntheticData::courseID(data.below(config.courses)));
+    }
+    for (const auto& request : requests) {
+        enroll.measure([&] { requestEnrollment(request.first, request.second); });
+    }
+    enroll.report("enrollStudent", size);
+
+    const int SAVE_RUNS = 20;
+    Latencies save;
+    for (int run = 0; run < SAVE_RUNS; ++run) {
+        for (int i = 0; i < 100; ++i) {
+            requestEnrollment(SyntheticData::studentID(data.below(size)),
+                              SyntheticData::courseID(data.below(config.courses)));
+        }
+        QuietOutput quiet;
+        save.measure([] { saveData(); });
+    }
+    save.report("saveData", size);
+
+    Latencies writeAll;
+    for (int run = 0; run < LOAD_RUNS; ++run) {
+        writeAll.measure([] { writeSnapshotFiles(); });
+    }
+    writeAll.report("saveData (full rewrite)", size);
+
+    // The binary snapshot, once written, takes precedence over the text file
+    writeSnapshot(SNAPSHOT_FILE);
+    Latencies loadSnapshotRuns;
+    for (int run = 0; run < LOAD_RUNS; ++run) {
+        resetData();
+        remove(JOURNAL_FILE.c_str());
+        QuietOutput quiet;
+        loadSnapshotRuns.measure([] { loadData(); });
+    }
+    loadSnapshotRuns.report("loadData (snapshot)", size);
+
+    resetData();
+    remove(SNAPSHOT_FILE.c_str());
+    remove(JOURNAL_FILE.c_str());
+    remove(DATA_FILE.c_str());
+}
+
+// ===== Grade management =====
+void benchmarkGrades(size_t size, const BenchmarkOptions& options) {
+    SyntheticConfig config;
+    config.students = size;
+    config.seed = options.seed;
+    SyntheticData data(config);
+
+    GradeManager manager;
+    {
+        QuietOutput quiet;
+        for (size_t i = 0; i < size; ++i) {
+            int id = static_cast<int>(i + 1);
+            manager.addStudent(SyntheticData::studentName(i), id);
+            int row = manager.findStudent(id);
+            for (int subject = 0; subject < SUBJECT_COUNT; ++subject) {
+                manager.setGrade(row, subject, data.grade());
+            }
+        }
+    }
+
+    Latencies find(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        int id = static_cast<int>(data.below(size) + 1);
+        find.measure([&] { keep(manager.findStudent(id)); });
+    }
+    find.report("findStudent (grades)", size);
+
+    const int STATS_RUNS = 50;
+    Latencies stats;
+    for (int run = 0; run < STATS_RUNS; ++run) {
+        vector<GradeStats> result;
+        stats.measure([&] { result = manager.subjectStatistics(); });
+        keep(result.data());
+    }
+    stats.report("subjectStatistics", size);
+
+    Latencies distribution;
+    for (int run = 0; run < STATS_RUNS; ++run) {
+        vector<vector<uint64_t>> result;
+        distribution.measure([&] { result = manager.gradeDistribution(); });
+        keep(result.data());
+    }
+    distribution.report("gradeDistribution", size);
+
+    // A grade change followed by a class position query: the rankings are
+    // kept up to date, against sorting every student's total after the change
+    Latencies ranked(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        int row = static_cast<int>(data.below(size));
+        int subject = static_cast<int>(data.below(SUBJECT_COUNT));
+        double grade = data.grade();
+        ranked.measure([&] {
+            manager.setGrade(row, subject, grade);
+            keep(static_cast<int>(manager.rankOf(row)));
+        });
+    }
+    ranked.report("setGrade + rankOf", size);
+
+    const size_t SORT_RUNS = min<size_t>(options.ops, 50);
+    Latencies sorted(SORT_RUNS);
+    vector<pair<double, int>> totals(size);
+    for (size_t i = 0; i < SORT_RUNS; ++i) {
+        int row = static_cast<int>(data.below(size));
+        int subject = static_cast<int>(data.below(SUBJECT_COUNT));
+        double grade = data.grade();
+        sorted.measure([&] {
+            manager.setGrade(row, subject, grade);
+            for (size_t r = 0; r < size; ++r) {
+                double total = 0.0;
+                for (int s = 0; s < SUBJECT_COUNT; ++s) total += manager.getGrade(static_cast<int>(r), s);
+                totals[r] = {-total, static_cast<int>(r)};
+            }
+            sort(totals.begin(), totals.end());
+            size_t position = 0;
+            while (totals[position].second != row) ++position;
+            keep(static_cast<int>(position));
+        });
+    }
+    sorted.report("setGrade + full sort", size);
+
+    Latencies topTen(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        int subject = static_cast<int>(data.below(SUBJECT_COUNT));
+        vector<int> best;
+        topTen.measure([&] { best = manager.topStudents(10, subject); });
+        keep(best.data());
+    }
+    topTen.report("topStudents (10)", size);
+
+    const int AVERAGE_RUNS = 20;
+    Latencies averages;
+    for (int run = 0; run < AVERAGE_RUNS; ++run) {
+        QuietOutput quiet;
+        averages.measure([&] { manager.displaySubjectAverages(); });
+    }
+    averages.report("displaySubjectAverages", size);
+}
+
+// Journaled grade changes, snapshot writes and loading the gradebook back
+void benchmarkGradeDatabase(size_t size, const BenchmarkOptions& options) {
+    const string path = "bench_grades.db";
+    const string logPath = "bench_grades.log";
+    remove(path.c_str());
+    remove(logPath.c_str());
+
+    SyntheticConfig config;
+    config.students = size;
+    config.seed = options.seed;
+    SyntheticData data(config);
+
+    unique_ptr<GradeManager> manager(new GradeManager());
+    {
+        QuietOutput quiet;
+        for (size_t i = 0; i < size; ++i) {
+            manager->addStudent(SyntheticData::studentName(i), static_cast<int>(i + 1));
+            for (int subject = 0; subject < SUBJECT_COUNT; ++subject) {
+                manager->setGrade(static_cast<int>(i), subject, data.grade());
+            }
+        }
+        if (!manager->openDatabase(path, logPath)) {
+            cout << "Cannot create " << path << ", grade database benchmark skipped\n";
+            return;
+        }
+    }
+
+    Latencies write(1);
+    write.measure([&] { manager->compactDatabase(); });
+    write.report("grade snapshot write", size);
+
+    Latencies change(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        int row = static_cast<int>(data.below(size));
+        int subject = static_cast<int>(data.below(SUBJECT_COUNT));
+        double grade = data.grade();
+        change.measure([&] { manager->setGrade(row, subject, grade); });
+    }
+    change.report("setGrade (journaled)", size);
+    manager.reset();
+
+    const int LOADS = 5;
+    Latencies load(LOADS);
+    for (int run = 0; run < LOADS; ++run) {
+        QuietOutput quiet;
+        unique_ptr<GradeManager> loaded(new GradeManager());
+        load.measure([&] { loaded->openDatabase(path, logPath); });
+        keep(loaded.get());
+    }
+    load.report("load grades.db + journal", size);
+    remove(path.c_str());
+    remove(logPath.c_str());
+}
+
+// ===== Attendance tracking =====
+void benchmarkAttendance(size_t size, const BenchmarkOptions& options) {
+    unique_ptr<SchoolAttendance> school;
+    {
+        QuietOutput quiet;
+        school.reset(new SchoolAttendance(static_cast<int>(size)));
+    }
+
+    SyntheticConfig config;
+    config.students = size;
+    config.subjects = school->subjectCount();
+    config.seed = options.seed;
+    SyntheticData data(config);
+
+    Latencies mark(options.ops);
+    {
+        QuietOutput quiet;
+        for (const auto& m : data.attendanceMarks(options.ops)) {
+            int studentId = static_cast<int>(m.first + 1);
+            int subjectId = static_cast<int>(m.second);
+            mark.measure([&] { school->markAttendance(studentId, subjectId); });
+        }
+    }
+    mark.report("markAttendance", size);
+
+    // Whole-class registers for C.R.E (taken by only part of the school),
+    // so the enrollment filter has students to reject
+    const int REGISTERS = 200;
+    const int CRE = 9;
+    vector<uint64_t> present(school->studentWordCount(), 0);
+    for (size_t student = 0; student < size; ++student) {
+        if (data.below(100) < 93) present[student / 64] |= uint64_t(1) << (student % 64);
+    }
+    Latencies bulk(REGISTERS);
+    uint64_t marks = 0;
+    for (int run = 0; run < REGISTERS; ++run) {
+        bulk.measure([&] { marks += school->markRegister(CRE, present.data()).marked; });
+    }
+    bulk.report("markRegister", size);
+    {
+        ReportWriter out;
+        out << "  bulk marking: ";
+        out.fixed(marks / (bulk.totalSeconds() * 1e6), 1) << " million marks/s\n";
+    }
+
+    const int REPORT_RUNS = 20;
+    Latencies reports;
+    for (int run = 0; run < REPORT_RUNS; ++run) {
+        QuietOutput quiet;
+        reports.measure([&] { school->saveAllReports(); });
+    }
+    reports.report("saveAllReports", size);
+    remove("school_report.txt");
+}
+
+// The same marking with attendance.dat and its log behind it, then the
+// cost of a checkpoint and of reopening the store
+void benchmarkAttendanceStore(size_t size, const BenchmarkOptions& options) {
+    const string path = "bench_attendance.dat";
+    const string logPath = "bench_attendance.log";
+    remove(path.c_str());
+    unique_ptr<SchoolAttendance> school;
+    {
+        QuietOutput quiet;
+        school.reset(new SchoolAttendance(static_cast<int>(size), SchoolAttendance::NAMED_SUBJECTS, path, logPath));
+    }
+    if (!school->isPersistent()) {
+        cout << "Cannot create " << path << ", store benchmark skipped\n";
+        return;
+    }
+
+    SyntheticConfig config;
+    config.students = size;
+    config.subjects = school->subjectCount();
+    config.seed = options.seed;
+    SyntheticData data(config);
+
+    Latencies mark(options.ops);
+    {
+        QuietOutput quiet;
+        for (const auto& m : data.attendanceMarks(options.ops)) {
+            int studentId = static_cast<int>(m.first + 1);
+            int subjectId = static_cast<int>(m.second);
+            mark.measure([&] { school->markAttendance(studentId, subjectId); });
+        }
+    }
+    mark.report("markAttendance (logged)", size);
+
+    const int REGISTERS = 200;
+    vector<uint64_t> present(school->studentWordCount(), ~uint64_t(0));
+    Latencies bulk(REGISTERS);
+    for (int run = 0; run < REGISTERS; ++run) {
+        bulk.measure([&] { school->markRegister(run % school->subjectCount(), present.data()); });
+    }
+    bulk.report("markRegister (logged)", size);
+
+    Latencies save(1);
+    {
+        QuietOutput quiet;
+        save.measure([&] { school->saveStore(); });
+    }
+    save.report("store checkpoint", size);
+    school.reset();
+
+    const int REOPENS = 20;
+    Latencies reopen(REOPENS);
+    for (int run = 0; run < REOPENS; ++run) {
+        QuietOutput quiet;
+        reopen.measure([&] {
+            SchoolAttendance reopened(static_cast<int>(size), SchoolAttendance::NAMED_SUBJECTS, path, logPath);
+            keep(&reopened);
+        });
+    }
+    reopen.report("reopen attendance.dat", size);
+    remove(path.c_str());
+    remove(logPath.c_str());
+}
+
+// Marks and registers from several submitting threads at once through
+// ConcurrentAttendance, and snapshots taken while they run
+void benchmarkIngest(size_t size, const BenchmarkOptions& options) {
+    const int PRODUCERS = 4;
+    const int APPLIERS = 2;
+    unique_ptr<SchoolAttendance> school;
+    {
+        QuietOutput quiet;
+        school.reset(new SchoolAttendance(static_cast<int>(size)));
+    }
+
+    SyntheticConfig config;
+    config.students = size;
+    config.subjects = school->subjectCount();
+    config.seed = options.seed;
+    SyntheticData data(config);
+    auto marks = data.attendanceMarks(options.ops);
+    vector<uint64_t> present(school->studentWordCount(), 0);
+    for (size_t student = 0; student < size; ++student) {
+        if (data.below(100) < 93) present[student / 64] |= uint64_t(1) << (student % 64);
+    }
+
+    // Producers split the single marks, or registerCount registers, between them
+    auto run = [&](const string& label, int registerCount) {
+        ConcurrentAttendance ingest(*school, APPLIERS);
+        auto started = chrono::steady_clock::now();
+        vector<thread> producers;
+        for (int t = 0; t < PRODUCERS; ++t) {
+            producers.emplace_back([&, t] {
+                if (registerCount > 0) {
+                    for (int r = t; r < registerCount; r += PRODUCERS) {
+                        ingest.submitRegister(r % school->subjectCount(), present);
+                    }
+                } else {
+                    for (size_t i = t; i < marks.size(); i += PRODUCERS) {
+                        ingest.submitMark(static_cast<int>(marks[i].first + 1), static_cast<int>(marks[i].second));
+                    }
+                }
+            });
+        }
+        for (thread& producer : producers) producer.join();
+        ingest.stop();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+        Latencies snapshots(20);
+        uint64_t applied = 0;
+        for (int i = 0; i < 20; ++i) {
+            snapshots.measure([&] { applied = ingest.snapshot().marks; });
+        }
+        {
+            ReportWriter out;
+            out << "  " << label << " (" << PRODUCERS << " producers, " << APPLIERS << " appliers): ";
+            out.fixed(applied / seconds / 1e6, 2) << " million marks/s\n";
+        }
+        snapshots.report("ingest snapshot", size);
+        QuietOutput quiet;
+        ingest.fold();
+    };
+
+    run("concurrent marks", 0);
+    run("concurrent registers", 200);
+}
+
+// Every student's and subject's report: one file at a time through
+// saveStudentReport(), then generateAllReports() on the thread pool, in
+// full and again after a few marks (only the changed reports)
+void benchmarkReports(size_t size, const BenchmarkOptions& options) {
+    const string directory = "attendance_reports";
+    unique_ptr<SchoolAttendance> school;
+    {
+        QuietOutput quiet;
+        school.reset(new SchoolAttendance(static_cast<int>(size)));
+    }
+
+    const int SEQUENTIAL = static_cast<int>(min<size_t>(size, 2000));
+    Latencies single(SEQUENTIAL);
+    {
+        QuietOutput quiet;
+        for (int studentId = 1; studentId <= SEQUENTIAL; ++studentId) {
+            single.measure([&] { school->saveStudentReport(studentId); });
+        }
+        for (int studentId = 1; studentId <= SEQUENTIAL; ++studentId) {
+            remove(SchoolAttendance::studentReportName(studentId).c_str());
+        }
+    }
+    single.report("saveStudentReport", size);
+
+    Latencies full(1);
+    SchoolAttendance::ReportRun run;
+    full.measure([&] { run = school->generateAllReports(directory); });
+    full.report("generateAllReports (all)", size);
+    cout << "  " << run.students + run.subjects << " reports written\n";
+
+    SyntheticConfig config;
+    config.students = size;
+    config.subjects = school->subjectCount();
+    config.seed = options.seed;
+    SyntheticData data(config);
+    {
+        QuietOutput quiet;
+        for (const auto& m : data.attendanceMarks(100)) {
+            school->markAttendance(static_cast<int>(m.first + 1), static_cast<int>(m.second));
+        }
+    }
+    Latencies incremental(1);
+    incremental.measure([&] { run = school->generateAllReports(directory); });
+    incremental.report("generateAllReports (100 marks)", size);
+    cout << "  " << run.students + run.subjects << " reports rewritten, " << run.unchanged << " unchanged\n";
+
+    error_code ignored;
+    filesystem::remove_all(directory, ignored);
+}
+
+// Min-cost-flow subject allocation: 40 optional subjects, six ranked
+// choices per student of which three are wanted, with popular subjects
+// oversubscribed so that some preferences go unmet
+void benchmarkSubjectAllocation(size_t size, const BenchmarkOptions& options) {
+    const int SUBJECTS = 40;
+    const int RANKED = 6;
+    const int WANTED = 3;
+
+    SyntheticConfig config;
+    config.students = size;
+    config.seed = options.seed;
+    SyntheticData data(config);
+
+    vector<SubjectPreferences> preferences(size);
+    for (SubjectPreferences& prefs : preferences) {
+        prefs.wanted = WANTED;
+        while (prefs.ranked.size() < RANKED) {
+            // Low-numbered subjects are the popular ones
+            int subject = static_cast<int>(min(data.below(SUBJECTS), data.below(SUBJECTS)));
+            if (find(prefs.ranked.begin(), prefs.ranked.end(), subject) == prefs.ranked.end()) {
+                prefs.ranked.push_back(subject);
+            }
+        }
+    }
+    // Enough places overall, spread evenly while demand is not
+    vector<int> capacity(SUBJECTS, static_cast<int>(size * WANTED * 11 / 10 / SUBJECTS));
+
+    const int RUNS = 3;
+    Latencies solve(RUNS);
+    SubjectAllocation result;
+    for (int run = 0; run < RUNS; ++run) {
+        solve.measure([&] {
+            SubjectAllocator allocator;
+            result = allocator.solve(capacity, preferences);
+        });
+    }
+    solve.report("allocateSubjects (40 subjects)", size);
+    cout << "  " << result.phases << " rounds, " << result.studentsShort << " students short of "
+         << result.placesShort << " subjects, first choices " << result.byRank[0] << "\n";
+}
+
+// A year of daily registers (one subject, every student enrolled, about
+// 7% absent each day), then date-range queries over it
+void benchmarkSessionRegister(size_t size, const BenchmarkOptions& options) {
+    unique_ptr<SchoolAttendance> school;
+    {
+        QuietOutput quiet;
+        school.reset(new SchoolAttendance(static_cast<int>(size)));
+    }
+
+    SyntheticConfig config;
+    config.students = size;
+    config.seed = options.seed;
+    SyntheticData data(config);
+
+    int firstDay;
+    parseDate("2026-01-01", firstDay);
+    const int DAYS = 365;
+    Latencies record(DAYS);
+    for (int day = firstDay; day < firstDay + DAYS; ++day) {
+        vector<int> absent;
+        for (size_t student = 1; student <= size; ++student) {
+            if (data.below(100) < 7) absent.push_back(static_cast<int>(student));
+        }
+        QuietOutput quiet;
+        record.measure([&] { school->recordSession(0, day, absent, true); });
+    }
+    record.report("recordSession", size);
+
+    const int QUERY_RUNS = 50;
+    Latencies schoolMonth, studentYear;
+    for (int run = 0; run < QUERY_RUNS; ++run) {
+        int from = firstDay + static_cast<int>(data.below(DAYS - 30));
+        int student = static_cast<int>(data.below(size) + 1);
+        QuietOutput quiet;
+        schoolMonth.measure([&] { school->showAttendancePercentage(0, from, from + 29); });
+        studentYear.measure([&] { school->showAttendancePercentage(student, firstDay, firstDay + DAYS - 1); });
+    }
+    schoolMonth.report("attendance % (school, month)", size);
+    studentYear.report("attendance % (student, year)", size);
+
+    ReportWriter out;
+    out << "  session register: " << school->sessionCount() << " sessions, ";
+    out.fixed(school->sessionBytes() / 1048576.0, 2) << " MiB\n";
+}
+
+// Parse "1000,10000,50000"
+bool parseSizes(const string& text, vector<size_t>& sizes) {
+    sizes.clear();
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        size_t size = strtoull(item.c_str(), nullptr, 10);
+        if (size == 0) return false;
+        sizes.push_back(size);
+    }
+    return !sizes.empty();
+}
+
+int generateData(int argc, char* argv[]) {
+    if (argc < 6) {
+        cout << "Usage: " << argv[0]
+             << " --generate <file> <students> <courses> <density> [seed]\n";
+        return 1;
+    }
+    SyntheticConfig config;
+    config.students = strtoull(argv[3], nullptr, 10);
+    config.courses = strtoull(argv[4], nullptr, 10);
+    config.enrollmentDensity = atof(argv[5]);
+    if (argc >= 7) config.seed = strtoull(argv[6], nullptr, 10);
+
+    SyntheticData data(config);
+    if (!data.writeEnrollmentText(argv[2])) {
+        cout << "Error: Could not write " << argv[2] << "\n";
+        return 1;
+    }
+    cout << "Wrote " << config.students << " students and " << config.courses
+         << " courses to " << argv[2] << "\n";
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && string(argv[1]) == "--generate") {
+        return generateData(argc, argv);
+    }
+
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sizes" && hasValue && parseSizes(argv[++i], options.sizes)) continue;
+        if (arg == "--ops" && hasValue) {
+            options.ops = max<size_t>(1, strtoull(argv[++i], nullptr, 10));
+            continue;
+        }
+        if (arg == "--seed" && hasValue) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+            continue;
+        }
+        cout << "Usage: " << argv[0] << " [--sizes n,n,...] [--ops n] [--seed n]\n"
+             << "       " << argv[0] << " --generate <file> <students> <courses> <density> [seed]\n";
+        return 1;
+    }
+
+    std::error_code error;
+    filesystem::create_directories("school_benchmark", error);
+    filesystem::current_path("school_benchmark", error);
+    if (error) {
+        cout << "Error: Could not use the school_benchmark directory\n";
+        return 1;
+    }
+
+    Latencies::header();
+    for (size_t size : options.sizes) {
+        benchmarkEnrollment(size, options);
+        benchmarkGrades(size, options);
+        benchmarkGradeDatabase(size, options);
+        benchmarkAttendance(size, options);
+        benchmarkAttendanceStore(size, options);
+        benchmarkIngest(size, options);
+        benchmarkReports(size, options);
+        benchmarkSubjectAllocation(size, options);
+        benchmarkSessionRegister(size, options);
+    }
+    return 0;
+}
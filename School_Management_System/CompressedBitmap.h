@@ -0,0 +1,288 @@
+#ifndef COMPRESSED_BITMAP_H
+#define COMPRESSED_BITMAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Number of set bits in a 64-bit word
+inline int popcount64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(word));
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<int>((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// Index of the lowest set bit (word must not be 0)
+inline int lowestBit64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    return popcount64((word & (0 - word)) - 1);
+#endif
+}
+
+// Compressed set of 32-bit integers (student numbers), roaring-style.
+//
+// Values are grouped by their upper 16 bits into containers of up to 65536
+// values. Each container uses whichever form is smallest for its contents:
+//   - array:  sorted 16-bit values (sparse sets)
+//   - bitmap: 65536 bits in 1024 words (dense sets)
+//   - runs:   (start, length - 1) pairs (long stretches of consecutive values)
+// Cardinalities are kept per container, so counting is free, and
+// intersections of bitmaps are word-wide ANDs with popcounts.
+class CompressedBitmap {
+public:
+    // Build from values in increasing order (duplicates are ignored)
+    static CompressedBitmap fromSorted(const uint32_t* values, size_t count) {
+        CompressedBitmap result;
+        size_t i = 0;
+        while (i < count) {
+            Container c;
+            c.key = static_cast<uint16_t>(values[i] >> 16);
+            for (; i < count && (values[i] >> 16) == c.key; ++i) {
+                uint16_t low = static_cast<uint16_t>(values[i]);
+                if (c.values.empty() || c.values.back() != low) c.values.push_back(low);
+            }
+            c.cardinality = static_cast<uint32_t>(c.values.size());
+            c.optimize();
+            result.containers.push_back(std::move(c));
+        }
+        return result;
+    }
+
+    static CompressedBitmap fromSorted(const std::vector<uint32_t>& values) {
+        return fromSorted(values.data(), values.size());
+    }
+
+    // Add one value (any order)
+    void add(uint32_t value) {
+        uint16_t key = static_cast<uint16_t>(value >> 16);
+        auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                                   [](const Container& c, uint16_t k) { return c.key < k; });
+        if (it == containers.end() || it->key != key) {
+            it = containers.insert(it, Container());
+            it->key = key;
+        }
+        it->add(static_cast<uint16_t>(value));
+    }
+
+    bool contains(uint32_t value) const {
+        const Container* c = find(static_cast<uint16_t>(value >> 16));
+        return c && c->contains(static_cast<uint16_t>(value));
+    }
+
+    uint64_t cardinality() const {
+        uint64_t total = 0;
+        for (const Container& c : containers) total += c.cardinality;
+        return total;
+    }
+
+    bool empty() const { return containers.empty(); }
+
+    // Size of the intersection, without building it
+    uint64_t andCardinality(const CompressedBitmap& other) const {
+        uint64_t total = 0;
+        size_t i = 0, j = 0;
+        while (i < containers.size() && j < other.containers.size()) {
+            const Container& a = containers[i];
+            const Container& b = other.containers[j];
+            if (a.key < b.key) {
+                i++;
+            } else if (b.key < a.key) {
+                j++;
+            } else {
+                total += Container::andCardinality(a, b);
+                i++;
+                j++;
+            }
+        }
+        return total;
+    }
+
+    // Call fn(value) for every value in increasing order
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Container& c : containers) {
+            uint32_t high = static_cast<uint32_t>(c.key) << 16;
+            c.forEach([&](uint16_t low) { fn(high | low); });
+        }
+    }
+
+    // Convert every container to its smallest form (after many add() calls)
+    void optimize() {
+        for (Container& c : containers) c.optimize();
+    }
+
+    // Memory held by the set's contents
+    size_t bytes() const {
+        size_t total = 0;
+        for (const Container& c : containers) {
+            total += sizeof(Container) + c.values.size() * sizeof(uint16_t) +
+                     c.bits.size() * sizeof(uint64_t);
+        }
+        return total;
+    }
+
+private:
+    enum Kind : uint8_t { ARRAY, BITMAP, RUNS };
+
+    static const uint32_t ARRAY_MAX = 4096;  // Past this a bitmap is smaller
+    static const size_t BITMAP_WORDS = 65536 / 64;
+
+    struct Container {
+        uint16_t key = 0;
+        Kind kind = ARRAY;
+        uint32_t cardinality = 0;
+        std::vector<uint16_t> values;  // ARRAY: sorted values; RUNS: start, length - 1
+        std::vector<uint64_t> bits;    // BITMAP
+
+        bool contains(uint16_t low) const {
+            switch (kind) {
+                case ARRAY:
+                    return std::binary_search(values.begin(), values.end(), low);
+                case BITMAP:
+                    return (bits[low >> 6] >> (low & 63)) & 1;
+                case RUNS: {
+                    // Last run starting at or before low
+                    size_t lo = 0, hi = values.size() / 2;
+                    while (lo < hi) {
+                        size_t mid = (lo + hi) / 2;
+                        if (values[2 * mid] <= low) lo = mid + 1; else hi = mid;
+                    }
+                    if (lo == 0) return false;
+                    uint16_t start = values[2 * (lo - 1)];
+                    return low - start <= values[2 * (lo - 1) + 1];
+                }
+            }
+            return false;
+        }
+
+        void add(uint16_t low) {
+            if (kind == RUNS) toBitmap();
+            if (kind == ARRAY) {
+                auto it = std::lower_bound(values.begin(), values.end(), low);
+                if (it != values.end() && *it == low) return;
+                if (cardinality < ARRAY_MAX) {
+                    values.insert(it, low);
+                    cardinality++;
+                    return;
+                }
+                toBitmap();
+            }
+            uint64_t& word = bits[low >> 6];
+            uint64_t bit = uint64_t(1) << (low & 63);
+            if (!(word & bit)) {
+                word |= bit;
+                cardinality++;
+            }
+        }
+
+        template <typename Fn>
+        void forEach(Fn&& fn) const {
+            switch (kind) {
+                case ARRAY:
+                    for (uint16_t low : values) fn(low);
+                    break;
+                case BITMAP:
+                    for (size_t w = 0; w < bits.size(); ++w) {
+                        for (uint64_t word = bits[w]; word; word &= word - 1) {
+                            fn(static_cast<uint16_t>(w * 64 + lowestBit64(word)));
+                        }
+                    }
+                    break;
+                case RUNS:
+                    for (size_t r = 0; r < values.size(); r += 2) {
+                        uint32_t start = values[r];
+                        for (uint32_t v = start; v <= start + values[r + 1]; ++v) {
+                            fn(static_cast<uint16_t>(v));
+                        }
+                    }
+                    break;
+            }
+        }
+
+        void toBitmap() {
+            std::vector<uint64_t> words(BITMAP_WORDS, 0);
+            forEach([&](uint16_t low) { words[low >> 6] |= uint64_t(1) << (low & 63); });
+            bits.swap(words);
+            values.clear();
+            values.shrink_to_fit();
+            kind = BITMAP;
+        }
+
+        // Pick the smallest of the three forms
+        void optimize() {
+            std::vector<uint16_t> sorted;
+            sorted.reserve(cardinality);
+            forEach([&](uint16_t low) { sorted.push_back(low); });
+
+            std::vector<uint16_t> runs;
+            for (size_t i = 0; i < sorted.size();) {
+                size_t j = i;
+                while (j + 1 < sorted.size() && sorted[j + 1] == sorted[j] + 1) j++;
+                runs.push_back(sorted[i]);
+                runs.push_back(static_cast<uint16_t>(j - i));
+                i = j + 1;
+            }
+
+            size_t arrayBytes = sorted.size() * sizeof(uint16_t);
+            size_t runBytes = runs.size() * sizeof(uint16_t);
+            size_t bitmapBytes = BITMAP_WORDS * sizeof(uint64_t);
+            if (runBytes < arrayBytes && runBytes < bitmapBytes) {
+                kind = RUNS;
+                values.swap(runs);
+                bits = std::vector<uint64_t>();
+            } else if (arrayBytes <= bitmapBytes) {
+                kind = ARRAY;
+                values.swap(sorted);
+                bits = std::vector<uint64_t>();
+            } else {
+                toBitmapFrom(sorted);
+            }
+            values.shrink_to_fit();
+        }
+
+        void toBitmapFrom(const std::vector<uint16_t>& sorted) {
+            bits.assign(BITMAP_WORDS, 0);
+            for (uint16_t low : sorted) bits[low >> 6] |= uint64_t(1) << (low & 63);
+            values = std::vector<uint16_t>();
+            kind = BITMAP;
+        }
+
+        static uint64_t andCardinality(const Container& a, const Container& b) {
+            if (a.kind == BITMAP && b.kind == BITMAP) {
+                uint64_t total = 0;
+                for (size_t w = 0; w < BITMAP_WORDS; ++w) total += popcount64(a.bits[w] & b.bits[w]);
+                return total;
+            }
+            // Probe the smaller side into the other
+            const Container& small = a.cardinality <= b.cardinality ? a : b;
+            const Container& large = &small == &a ? b : a;
+            uint64_t total = 0;
+            small.forEach([&](uint16_t low) { total += large.contains(low); });
+            return total;
+        }
+
+    };
+
+    const Container* find(uint16_t key) const {
+        auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                                   [](const Container& c, uint16_t k) { return c.key < k; });
+        return it != containers.end() && it->key == key ? &*it : nullptr;
+    }
+
+    std::vector<Container> containers;  // Sorted by key
+};
+
+#endif
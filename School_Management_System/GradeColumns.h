@@ -0,0 +1,268 @@
+#ifndef GRADE_COLUMNS_H
+#define GRADE_COLUMNS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "ThreadPool.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define GRADE_COLUMNS_SSE2 1
+#if defined(__GNUC__) || defined(__clang__) || defined(__AVX2__)
+#define GRADE_COLUMNS_AVX2 1
+#endif
+#endif
+
+// Summary of one grade column
+struct GradeStats {
+    size_t count = 0;
+    double average = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double stddev = 0.0;  // Population standard deviation
+};
+
+// Grades stored subject-major: one contiguous float column per subject,
+// with a student's grades at the same row of every column.
+//
+// Per-subject statistics then stream through one array with vector loads
+// (AVX2 where the CPU has it, else SSE2, else plain C++). The vector lanes
+// add in a different order than a plain loop, so results agree with it to
+// within double rounding, not bit for bit. Each block sums its grades
+// minus the block's first grade, in double, which keeps the variance from
+// cancelling away; blocks are then merged by their means and squared
+// deviations (Chan et al.), so the spread never comes out negative.
+// Large columns are cut into blocks that a ThreadPool works through in
+// parallel.
+class GradeColumns {
+public:
+    // Columns shorter than this are summarized on the calling thread
+    static const size_t PARALLEL_ROWS = 1 << 16;
+    static const size_t BLOCK_ROWS = 1 << 15;
+
+    explicit GradeColumns(int subjects) : columns(subjects) {}
+
+    int subjects() const { return static_cast<int>(columns.size()); }
+    size_t size() const { return rows; }
+
+    // Append a row of zero grades and return its index
+    size_t addRow() {
+        for (std::vector<float>& column : columns) column.push_back(0.0f);
+        return rows++;
+    }
+
+    void reserve(size_t capacity) {
+        for (std::vector<float>& column : columns) column.reserve(capacity);
+    }
+
+    // Grow or shrink to this many rows (new rows are zero), for bulk loads
+    // that then fill whole columns at once
+    void resize(size_t count) {
+        for (std::vector<float>& column : columns) column.resize(count, 0.0f);
+        rows = count;
+    }
+
+    float get(size_t row, int subject) const { return columns[subject][row]; }
+    void set(size_t row, int subject, float grade) { columns[subject][row] = grade; }
+
+    const float* column(int subject) const { return columns[subject].data(); }
+    float* column(int subject) { return columns[subject].data(); }
+
+    // Statistics of one subject; pool (optional) splits large columns
+    GradeStats stats(int subject, ThreadPool* pool = nullptr) const {
+        return allStats(pool, subject, subject + 1)[0];
+    }
+
+    // Statistics of every subject, in subject order
+    std::vector<GradeStats> allStats(ThreadPool* pool = nullptr) const {
+        return allStats(pool, 0, subjects());
+    }
+
+private:
+    // Running sums of a block of grades, taken relative to shift
+    struct Sums {
+        float shift = 0.0f;
+        size_t count = 0;
+        double sum = 0.0;      // Of grade - shift
+        double squares = 0.0;  // Of (grade - shift)^2
+        float min = 0.0f;
+        float max = 0.0f;
+    };
+
+    // Summary of a block of grades: mean and sum of squared deviations
+    struct Totals {
+        size_t count = 0;
+        double mean = 0.0;
+        double deviations = 0.0;
+        float min = 0.0f;
+        float max = 0.0f;
+
+        Totals() = default;
+        explicit Totals(const Sums& sums) : count(sums.count), min(sums.min), max(sums.max) {
+            if (count == 0) return;
+            mean = sums.shift + sums.sum / count;
+            deviations = std::max(0.0, sums.squares - sums.sum * sums.sum / count);
+        }
+
+        void merge(const Totals& other) {
+            if (other.count == 0) return;
+            if (count == 0) {
+                *this = other;
+                return;
+            }
+            const double total = static_cast<double>(count) + other.count;
+            const double delta = other.mean - mean;
+            mean += delta * other.count / total;
+            deviations += other.deviations + delta * delta * count * other.count / total;
+            min = std::min(min, other.min);
+            max = std::max(max, other.max);
+            count += other.count;
+        }
+    };
+
+    std::vector<GradeStats> allStats(ThreadPool* pool, int first, int last) const {
+        const size_t blocks = rows >= PARALLEL_ROWS && pool ? (rows + BLOCK_ROWS - 1) / BLOCK_ROWS : 1;
+        const size_t blockRows = blocks == 1 ? rows : BLOCK_ROWS;
+        const int count = last - first;
+        std::vector<Totals> partial(static_cast<size_t>(count) * blocks);
+
+        auto job = [&](size_t index, size_t) {
+            size_t block = index % blocks;
+            size_t begin = block * blockRows;
+            size_t end = std::min(rows, begin + blockRows);
+            partial[index] = summarize(columns[first + index / blocks].data() + begin, end - begin);
+        };
+        if (blocks > 1) {
+            pool->parallelFor(partial.size(), job);
+        } else {
+            for (size_t index = 0; index < partial.size(); ++index) job(index, 0);
+        }
+
+        std::vector<GradeStats> result(count);
+        for (int subject = 0; subject < count; ++subject) {
+            Totals totals;
+            for (size_t block = 0; block < blocks; ++block) totals.merge(partial[subject * blocks + block]);
+            GradeStats& stats = result[subject];
+            stats.count = totals.count;
+            if (totals.count == 0) continue;
+            stats.average = totals.mean;
+            stats.min = totals.min;
+            stats.max = totals.max;
+            stats.stddev = std::sqrt(totals.deviations / totals.count);
+        }
+        return result;
+    }
+
+    // Totals of n grades with the fastest kernel the CPU supports
+    static Totals summarize(const float* grades, size_t n) {
+        Sums sums;
+        if (n > 0) sums.shift = grades[0];
+#if defined(GRADE_COLUMNS_AVX2)
+        static const bool avx2 = hasAvx2();
+        if (avx2) return Totals(summarizeAvx2(grades, n, sums));
+#endif
+#if defined(GRADE_COLUMNS_SSE2)
+        return Totals(summarizeSse2(grades, n, sums));
+#else
+        return Totals(summarizeScalar(grades, n, sums));
+#endif
+    }
+
+    // Fold grades [0, n) into sums (also finishes the vector kernels' tails)
+    static Sums summarizeScalar(const float* grades, size_t n, Sums sums) {
+        for (size_t i = 0; i < n; ++i) {
+            float grade = grades[i];
+            double offset = static_cast<double>(grade) - sums.shift;
+            sums.min = sums.count == 0 ? grade : std::min(sums.min, grade);
+            sums.max = sums.count == 0 ? grade : std::max(sums.max, grade);
+            sums.count++;
+            sums.sum += offset;
+            sums.squares += offset * offset;
+        }
+        return sums;
+    }
+
+#if defined(GRADE_COLUMNS_SSE2)
+    static Sums summarizeSse2(const float* grades, size_t n, Sums running) {
+        if (n < 4) return summarizeScalar(grades, n, running);
+
+        const __m128d shift = _mm_set1_pd(running.shift);
+        __m128 low = _mm_loadu_ps(grades), high = low;
+        __m128d sum = _mm_setzero_pd(), squares = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128 v = _mm_loadu_ps(grades + i);
+            low = _mm_min_ps(low, v);
+            high = _mm_max_ps(high, v);
+            __m128d a = _mm_sub_pd(_mm_cvtps_pd(v), shift);
+            __m128d b = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(v, v)), shift);
+            sum = _mm_add_pd(sum, _mm_add_pd(a, b));
+            squares = _mm_add_pd(squares, _mm_add_pd(_mm_mul_pd(a, a), _mm_mul_pd(b, b)));
+        }
+
+        alignas(16) float lanes[4];
+        alignas(16) double sums[2];
+        _mm_store_ps(lanes, low);
+        running.min = *std::min_element(lanes, lanes + 4);
+        _mm_store_ps(lanes, high);
+        running.max = *std::max_element(lanes, lanes + 4);
+        _mm_store_pd(sums, sum);
+        running.sum = sums[0] + sums[1];
+        _mm_store_pd(sums, squares);
+        running.squares = sums[0] + sums[1];
+        running.count = i;
+        return summarizeScalar(grades + i, n - i, running);
+    }
+#endif
+
+#if defined(GRADE_COLUMNS_AVX2)
+    static bool hasAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_cpu_supports("avx2");
+#else
+        return true;  // Built with /arch:AVX2
+#endif
+    }
+
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((target("avx2")))
+#endif
+    static Sums summarizeAvx2(const float* grades, size_t n, Sums running) {
+        if (n < 8) return summarizeScalar(grades, n, running);
+
+        const __m256d shift = _mm256_set1_pd(running.shift);
+        __m256 low = _mm256_loadu_ps(grades), high = low;
+        __m256d sum = _mm256_setzero_pd(), squares = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 v = _mm256_loadu_ps(grades + i);
+            low = _mm256_min_ps(low, v);
+            high = _mm256_max_ps(high, v);
+            __m256d a = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(v)), shift);
+            __m256d b = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)), shift);
+            sum = _mm256_add_pd(sum, _mm256_add_pd(a, b));
+            squares = _mm256_add_pd(squares, _mm256_add_pd(_mm256_mul_pd(a, a), _mm256_mul_pd(b, b)));
+        }
+
+        alignas(32) float lanes[8];
+        alignas(32) double sums[4];
+        _mm256_store_ps(lanes, low);
+        running.min = *std::min_element(lanes, lanes + 8);
+        _mm256_store_ps(lanes, high);
+        running.max = *std::max_element(lanes, lanes + 8);
+        _mm256_store_pd(sums, sum);
+        running.sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        _mm256_store_pd(sums, squares);
+        running.squares = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        running.count = i;
+        return summarizeScalar(grades + i, n - i, running);
+    }
+#endif
+
+    std::vector<std::vector<float>> columns;
+    size_t rows = 0;
+};
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef GRADE_RANKING_H
+#define GRADE_RANKING_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Counts per bucket with prefix sums, both in O(log buckets)
+class FenwickTree {
+public:
+    explicit FenwickTree(int buckets = 0) : tree(buckets + 1, 0) {}
+
+    // A tree over these counts, built in O(buckets)
+    explicit FenwickTree(const std::vector<int64_t>& counts) : tree(counts.size() + 1, 0) {
+        for (size_t i = 1; i < tree.size(); ++i) {
+            tree[i] += counts[i - 1];
+            size_t parent = i + (i & (0 - i));
+            if (parent < tree.size()) tree[parent] += tree[i];
+        }
+    }
+
+    int size() const { return static_cast<int>(tree.size()) - 1; }
+
+    void add(int bucket, int64_t delta) {
+        for (int i = bucket + 1; i < static_cast<int>(tree.size()); i += i & -i) tree[i] += delta;
+    }
+
+    // Sum of buckets [0, bucket]; 0 for bucket < 0
+    int64_t prefix(int bucket) const {
+        int64_t sum = 0;
+        for (int i = bucket + 1; i > 0; i -= i & -i) sum += tree[i];
+        return sum;
+    }
+
+    // Lowest bucket whose prefix sum reaches k (k >= 1), or size() if none.
+    // Counts must not be negative.
+    int lowerBound(int64_t k) const {
+        int pos = 0;
+        int step = 1;
+        while (step * 2 < static_cast<int>(tree.size())) step *= 2;
+        for (; step > 0; step /= 2) {
+            if (pos + step < static_cast<int>(tree.size()) && tree[pos + step] < k) {
+                pos += step;
+                k -= tree[pos];
+            }
+        }
+        return pos;
+    }
+
+private:
+    std::vector<int64_t> tree;  // 1-based
+};
+
+// Order statistics of one score per row (student), kept up to date as
+// scores change.
+//
+// Scores are bucketed (a tenth of a point per bucket, say) and a Fenwick
+// tree counts the rows in each bucket, so a row's rank, its percentile and
+// the score at a given position all cost O(log buckets) however many rows
+// there are. Each bucket also lists its rows, which is what top() walks.
+// Rows in the same bucket tie: rank is 1 + the number of rows strictly
+// higher, as in "joint 3rd".
+class ScoreRanking {
+public:
+    explicit ScoreRanking(int buckets = 0) : tree(buckets), members(buckets) {}
+
+    size_t size() const { return bucketOf.size(); }
+    int buckets() const { return tree.size(); }
+
+    // Append a row with the given score bucket (rows are numbered 0, 1, ...)
+    void addRow(int bucket) {
+        bucketOf.push_back(bucket);
+        slot.push_back(static_cast<int>(members[bucket].size()));
+        members[bucket].push_back(static_cast<int>(bucketOf.size() - 1));
+        tree.add(bucket, 1);
+    }
+
+    // Replace all rows at once: row i gets bucket rowBuckets[i]. Linear, for
+    // bulk loads.
+    void assign(const std::vector<int>& rowBuckets) {
+        std::vector<int64_t> counts(members.size(), 0);
+        for (int bucket : rowBuckets) counts[bucket]++;
+        for (size_t bucket = 0; bucket < members.size(); ++bucket) {
+            members[bucket].clear();
+            members[bucket].reserve(static_cast<size_t>(counts[bucket]));
+        }
+
+        bucketOf = rowBuckets;
+        slot.resize(rowBuckets.size());
+        for (size_t row = 0; row < rowBuckets.size(); ++row) {
+            std::vector<int>& list = members[rowBuckets[row]];
+            slot[row] = static_cast<int>(list.size());
+            list.push_back(static_cast<int>(row));
+        }
+        tree = FenwickTree(counts);
+    }
+
+    // A row's score moved to another bucket
+    void update(size_t row, int bucket) {
+        int old = bucketOf[row];
+        if (old == bucket) return;
+
+        // Swap-remove from the old bucket's list
+        std::vector<int>& from = members[old];
+        int last = from.back();
+        from[slot[row]] = last;
+        slot[last] = slot[row];
+        from.pop_back();
+
+        slot[row] = static_cast<int>(members[bucket].size());
+        members[bucket].push_back(static_cast<int>(row));
+        bucketOf[row] = bucket;
+        tree.add(old, -1);
+        tree.add(bucket, 1);
+    }
+
+    int bucket(size_t row) const { return bucketOf[row]; }
+
+    // 1-based position of a row, ties sharing the best position
+    size_t rank(size_t row) const {
+        return static_cast<size_t>(size() - tree.prefix(bucketOf[row])) + 1;
+    }
+
+    // Percent of rows scoring at or below this row
+    double percentile(size_t row) const {
+        return 100.0 * tree.prefix(bucketOf[row]) / size();
+    }
+
+    // Bucket of the score at a percentile (0-100): the lowest score that at
+    // least that percent of rows are at or below. -1 if there are no rows.
+    int bucketAtPercentile(double percent) const {
+        if (size() == 0) return -1;
+        int64_t k = static_cast<int64_t>(std::ceil(percent / 100.0 * size()));
+        if (k < 1) k = 1;
+        if (k > static_cast<int64_t>(size())) k = static_cast<int64_t>(size());
+        return tree.lowerBound(k);
+    }
+
+    // The best k rows, best first. Ties are listed in no particular order,
+    // and a tie at the cut-off is cut at k rows.
+    std::vector<int> top(size_t k) const {
+        std::vector<int> rows;
+        rows.reserve(k < size() ? k : size());
+        int64_t below = static_cast<int64_t>(size());  // Rows in the buckets not visited yet
+        while (rows.size() < k && below > 0) {
+            // Highest non-empty bucket among the ones not visited yet
+            int bucket = tree.lowerBound(below);
+            for (int row : members[bucket]) {
+                if (rows.size() == k) break;
+                rows.push_back(row);
+            }
+            below -= static_cast<int64_t>(members[bucket].size());
+        }
+        return rows;
+    }
+
+private:
+    FenwickTree tree;
+    std::vector<std::vector<int>> members;  // Per bucket: its rows
+    std::vector<int> bucketOf;              // Per row
+    std::vector<int> slot;                  // Per row: position in its bucket's list
+};
+
+#endif
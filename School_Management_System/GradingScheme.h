@@ -0,0 +1,199 @@
+#ifndef GRADING_SCHEME_H
+#define GRADING_SCHEME_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__) || defined(__AVX2__))
+#include <immintrin.h>
+#define GRADING_SCHEME_AVX2 1
+#endif
+
+// A letter grade and the lowest score that earns it, in tenths of a point.
+// The letter is stored in the band itself, so a scheme never refers to
+// strings owned by someone else.
+struct GradeBand {
+    static const size_t MAX_LETTER = 15;
+
+    int minTenths;
+    char letter[MAX_LETTER + 1];
+};
+
+// Letter grades from best to worst. A grade's code is its band's position.
+struct GradingScheme {
+    static const int MAX_BANDS = 16;
+
+    std::array<GradeBand, MAX_BANDS> bands{};
+    int count = 0;
+
+    // Append a band below the existing ones (copies the letter). False if
+    // the scheme is full or the letter is too long.
+    bool add(int minTenths, std::string_view letter) {
+        if (count == MAX_BANDS || letter.size() > GradeBand::MAX_LETTER) return false;
+        GradeBand& band = bands[count++];
+        band = GradeBand{};
+        band.minTenths = minTenths;
+        std::copy(letter.begin(), letter.end(), band.letter);
+        return true;
+    }
+
+    // Cutoffs strictly falling, within 0-100 points, and the last band at 0
+    // so that every score has a letter
+    constexpr bool valid() const {
+        if (count < 1 || count > MAX_BANDS || bands[count - 1].minTenths != 0) return false;
+        for (int band = 0; band < count; ++band) {
+            if (bands[band].minTenths < 0 || bands[band].minTenths > 1000) return false;
+            if (band > 0 && bands[band].minTenths >= bands[band - 1].minTenths) return false;
+            if (bands[band].letter[GradeBand::MAX_LETTER] != '\0') return false;
+        }
+        return true;
+    }
+};
+
+// The KCSE scale
+constexpr GradingScheme KCSE_GRADING = {{{
+    {800, "A"}, {750, "A-"}, {700, "B+"}, {650, "B"}, {600, "B-"}, {550, "C+"},
+    {500, "C"}, {450, "C-"}, {400, "D+"}, {350, "D"}, {300, "D-"}, {0, "E"}
+}}, 12};
+
+static_assert(KCSE_GRADING.valid(), "KCSE cutoffs out of order");
+
+// A grading scheme unrolled into a code for every score from 0.0 to 100.0
+// in steps of a tenth, so grading one score is a multiply, a clamp and a
+// load instead of a chain of comparisons.
+//
+// A grade earns a band when its stored (float) value is at least the
+// band's cutoff, exactly: 79.99999 is below 80 and 79.9 is 79.9. The table
+// is indexed by the grade times ten rounded down, and that product is
+// taken in double, where it is exact for every float, so indexing never
+// rounds a grade across a cutoff.
+//
+// With AVX2, whole columns are counted without the table. For each block
+// of grades small enough to stay in L1, every band's cutoff is compared
+// against all the grades eight at a time, which counts the grades at or
+// above each cutoff; a band's count is then the difference between its
+// cutoff's and the next higher one's. The compares use the lowest float
+// that reaches each cutoff, so they agree with the table on every grade.
+// Without AVX2 the table is faster than narrower compares, so columns go
+// through it grade by grade.
+class GradeTable {
+public:
+    static const int STEPS = 1001;
+    static const size_t BLOCK = 2048;  // Grades per pass of the AVX2 kernel (8 KiB)
+
+    constexpr explicit GradeTable(const GradingScheme& scheme) : scheme(scheme), codes() {
+        int band = 0;
+        for (int tenths = STEPS - 1; tenths >= 0; --tenths) {
+            while (tenths < scheme.bands[band].minTenths) band++;
+            codes[tenths] = static_cast<uint8_t>(band);
+        }
+    }
+
+    constexpr const GradingScheme& grading() const { return scheme; }
+    constexpr int bandCount() const { return scheme.count; }
+
+    // Code of one grade (0 = the best letter)
+    constexpr uint8_t code(float grade) const { return codes[step(grade)]; }
+
+    // Letters stay valid as long as this table does
+    std::string_view letter(float grade) const { return scheme.bands[code(grade)].letter; }
+    std::string_view letterOf(int code) const { return scheme.bands[code].letter; }
+
+    // Lowest grade that earns a band
+    static float cutoffGrade(int minTenths) {
+        float grade = static_cast<float>(minTenths / 10.0);
+        while (step(grade) < minTenths) grade = std::nextafter(grade, 101.0f);
+        while (grade > 0.0f && step(std::nextafter(grade, 0.0f)) >= minTenths) {
+            grade = std::nextafter(grade, 0.0f);
+        }
+        return grade;
+    }
+
+    // Add the codes of grades [0, n) to counts (one entry per band).
+    // Grades must not be negative.
+    void countGrades(const float* grades, size_t n, uint64_t* counts) const {
+        size_t done = 0;
+#if defined(GRADING_SCHEME_AVX2)
+        static const bool avx2 = hasAvx2();
+        if (avx2) done = countGradesAvx2(grades, n, counts);
+#endif
+        for (size_t i = done; i < n; ++i) counts[code(grades[i])]++;
+    }
+
+private:
+    // Score in tenths rounded down, clamped to the table (exact: a float
+    // times ten always fits in a double)
+    static constexpr int step(float grade) {
+        return static_cast<int>(std::min(std::max(static_cast<double>(grade) * 10.0, 0.0), STEPS - 1.0));
+    }
+
+#if defined(GRADING_SCHEME_AVX2)
+    static bool hasAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_cpu_supports("avx2");
+#else
+        return true;  // Built with /arch:AVX2
+#endif
+    }
+
+    // Count the whole vectors of grades; returns how many grades that was
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((target("avx2")))
+#endif
+    size_t countGradesAvx2(const float* grades, size_t n, uint64_t* counts) const {
+        uint64_t atLeast[GradingScheme::MAX_BANDS] = {};
+        float cutoffs[GradingScheme::MAX_BANDS];
+        for (int band = 0; band < scheme.count; ++band) cutoffs[band] = cutoffGrade(scheme.bands[band].minTenths);
+
+        const size_t vectors = n / 8 * 8;
+        for (size_t begin = 0; begin < vectors; begin += BLOCK) {
+            const size_t end = std::min(vectors, begin + BLOCK);
+            for (int band = 0; band < scheme.count; ++band) {
+                const __m256 cutoff = _mm256_set1_ps(cutoffs[band]);
+                __m256i counter = _mm256_setzero_si256();
+                for (size_t i = begin; i < end; i += 8) {
+                    // A passing lane compares as all ones, i.e. -1
+                    __m256 passed = _mm256_cmp_ps(_mm256_loadu_ps(grades + i), cutoff, _CMP_GE_OQ);
+                    counter = _mm256_sub_epi32(counter, _mm256_castps_si256(passed));
+                }
+                alignas(32) uint32_t lanes[8];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), counter);
+                for (uint32_t lane : lanes) atLeast[band] += lane;
+            }
+        }
+
+        for (int band = 0; band < scheme.count; ++band) {
+            counts[band] += atLeast[band] - (band > 0 ? atLeast[band - 1] : 0);
+        }
+        return vectors;
+    }
+#endif
+
+    GradingScheme scheme;
+    std::array<uint8_t, STEPS> codes;
+};
+
+constexpr GradeTable KCSE_GRADE_TABLE(KCSE_GRADING);
+
+// Every cutoff earns its own band and the float just below it (79.99999
+// for 80) the next one down
+constexpr bool cutoffsHold(const GradeTable& table) {
+    const GradingScheme& scheme = table.grading();
+    for (int band = 0; band < scheme.count; ++band) {
+        float cutoff = static_cast<float>(scheme.bands[band].minTenths / 10.0);
+        if (table.code(cutoff) != band) return false;
+        if (band < scheme.count - 1 && table.code(cutoff - cutoff * 1e-7f) != band + 1) return false;
+    }
+    return true;
+}
+
+static_assert(cutoffsHold(KCSE_GRADE_TABLE), "KCSE table disagrees with its cutoffs");
+static_assert(KCSE_GRADE_TABLE.code(79.9f) == 1 && KCSE_GRADE_TABLE.code(79.99999f) == 1 &&
+              KCSE_GRADE_TABLE.code(0.0f) == 11 && KCSE_GRADE_TABLE.code(100.0f) == 0,
+              "KCSE table disagrees with its cutoffs");
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Bounded multi-producer, multi-consumer queue without locks (Vyukov's ring).
+//
+// Every cell carries a sequence number that says whose turn it is: a
+// producer may fill the cell at position p when its sequence is p, a
+// consumer may empty it when its sequence is p + 1. Producers and consumers
+// each claim positions with one compare-and-swap on their own counter, so
+// they never block each other; a full or empty queue simply makes the call
+// return false. The capacity is rounded up to a power of two.
+template <typename T>
+class MpmcQueue {
+public:
+    explicit MpmcQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    // False if the queue is full (value is left untouched)
+    bool tryPush(T& value) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // The consumer of the previous lap hasn't taken it yet
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // False if the queue is empty
+    bool tryPop(T& out) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.value);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    // Producers and consumers update different counters; keep them on
+    // separate cache lines
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) size_t mask;
+    std::unique_ptr<Cell[]> cells;
+};
+
+#endif
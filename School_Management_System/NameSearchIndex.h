@@ -0,0 +1,254 @@
+#ifndef NAME_SEARCH_INDEX_H
+#define NAME_SEARCH_INDEX_H
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// In-memory search index over student names, shared by the programs that
+// look students up by name.
+//
+// Names are split into lowercase words. Each distinct word is stored once
+// in a sorted vocabulary (for prefix queries) and in a trigram index (for
+// typo-tolerant queries); every word keeps the list of records using it.
+// Since a school has far fewer distinct words than names, queries only ever
+// scan small parts of the vocabulary.
+//
+// A query matches a record when every query word matches one of the
+// record's words, either as a prefix ("smi" -> "Smith") or as a whole word
+// within the edit distance limit ("jonh" -> "John"). Records are numbered
+// by the caller (normally their position in its vector) and added one at a
+// time as students are registered.
+class NameSearchIndex {
+public:
+    struct Match {
+        uint32_t id;  // Record number given to add()
+        int score;    // Lower is better: 0 means every word matched exactly
+    };
+
+    // Index a record's name
+    void add(uint32_t id, std::string_view name) {
+        if (id >= recordWords.size()) recordWords.resize(id + 1);
+
+        for (const std::string& word : splitWords(name)) {
+            uint32_t wordNo = internWord(word);
+            auto& ids = postings[wordNo];
+            if (ids.empty() || ids.back() != id) ids.push_back(id);
+            recordWords[id].push_back(wordNo);
+        }
+        records++;
+    }
+
+    // The best k records for a query, best first (ties by record number).
+    // maxDistance is the largest edit distance accepted for a whole word; it
+    // is reduced for short words (one typo per four letters), where
+    // anything larger matches almost everything.
+    std::vector<Match> search(std::string_view query, size_t k, int maxDistance = 2) const {
+        std::vector<Match> results;
+        std::vector<std::string> terms = splitWords(query);
+        if (terms.empty() || k == 0) return results;
+
+        // Score every vocabulary word each term can match. scores[t][word]
+        // is NO_MATCH for words term t does not match.
+        std::vector<std::vector<WordMatch>> termMatches(terms.size());
+        std::vector<std::vector<uint8_t>> scores(terms.size());
+        size_t seedTerm = 0, seedVolume = SIZE_MAX;
+        for (size_t t = 0; t < terms.size(); ++t) {
+            matchTerm(terms[t], maxDistance, termMatches[t]);
+            if (termMatches[t].empty()) return results;  // Nothing can match every term
+
+            scores[t].assign(words.size(), NO_MATCH);
+            size_t volume = 0;
+            for (const WordMatch& match : termMatches[t]) {
+                scores[t][match.word] = static_cast<uint8_t>(match.score);
+                volume += postings[match.word].size();
+            }
+            if (volume < seedVolume) {
+                seedVolume = volume;
+                seedTerm = t;
+            }
+        }
+
+        // Candidates come from the most selective term, best-scoring words
+        // first; the other terms are checked against each candidate's own
+        // (few) words. A record is first reached through its best word for
+        // that term, so once k results are in hand, words scoring worse
+        // than the k-th result cannot improve the answer.
+        std::vector<uint8_t> seen(recordWords.size(), 0);
+        auto better = [](const Match& a, const Match& b) {
+            return a.score != b.score ? a.score < b.score : a.id < b.id;
+        };
+        int kthScore = INT_MAX;
+
+        for (const WordMatch& seed : termMatches[seedTerm]) {
+            if (seed.score > kthScore) break;
+
+            for (uint32_t id : postings[seed.word]) {
+                if (seen[id]) continue;
+                seen[id] = 1;
+
+                int total = 0;
+                for (size_t t = 0; t < terms.size() && total >= 0; ++t) {
+                    int best = NO_MATCH;
+                    for (uint32_t wordNo : recordWords[id]) {
+                        best = std::min<int>(best, scores[t][wordNo]);
+                    }
+                    total = best == NO_MATCH ? -1 : total + best;
+                }
+                if (total >= 0) results.push_back({id, total});
+            }
+
+            if (results.size() >= k) {
+                std::nth_element(results.begin(), results.begin() + (k - 1), results.end(), better);
+                results.resize(k);
+                kthScore = results.back().score;
+            }
+        }
+
+        std::sort(results.begin(), results.end(), better);
+        if (results.size() > k) results.resize(k);
+        return results;
+    }
+
+    size_t size() const { return records; }
+
+private:
+    // Lowercase words of a name. Letters, digits and any non-ASCII byte
+    // (so UTF-8 names stay intact) form words; everything else separates them.
+    static std::vector<std::string> splitWords(std::string_view text) {
+        std::vector<std::string> words;
+        std::string word;
+        for (char ch : text) {
+            unsigned char c = static_cast<unsigned char>(ch);
+            if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80) {
+                word += ch;
+            } else if (c >= 'A' && c <= 'Z') {
+                word += static_cast<char>(c - 'A' + 'a');
+            } else if (!word.empty()) {
+                words.push_back(std::move(word));
+                word.clear();
+            }
+        }
+        if (!word.empty()) words.push_back(std::move(word));
+        return words;
+    }
+
+    // Distinct padded trigrams of a word ("ann" -> "$$a", "$an", "ann", "nn$", "n$$")
+    static std::vector<uint32_t> trigrams(const std::string& word) {
+        std::string padded = "$$" + word + "$$";
+        std::vector<uint32_t> grams;
+        for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+            grams.push_back(static_cast<unsigned char>(padded[i]) << 16 |
+                            static_cast<unsigned char>(padded[i + 1]) << 8 |
+                            static_cast<unsigned char>(padded[i + 2]));
+        }
+        std::sort(grams.begin(), grams.end());
+        grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+        return grams;
+    }
+
+    uint32_t internWord(const std::string& word) {
+        auto inserted = vocabulary.emplace(word, static_cast<uint32_t>(words.size()));
+        if (!inserted.second) return inserted.first->second;
+
+        uint32_t wordNo = inserted.first->second;
+        words.push_back(&inserted.first->first);
+        postings.emplace_back();
+        for (uint32_t gram : trigrams(word)) {
+            trigramWords[gram].push_back(wordNo);
+        }
+        return wordNo;
+    }
+
+    static const uint8_t NO_MATCH = 255;
+
+    struct WordMatch {
+        uint32_t word;  // Word number
+        int score;
+    };
+
+    // Collect the vocabulary words a query term matches, best score first:
+    // exact word 0, prefix 1, whole word at edit distance d: 2 * d
+    void matchTerm(const std::string& term, int maxDistance, std::vector<WordMatch>& matches) const {
+        std::vector<uint8_t> best(words.size(), NO_MATCH);
+        std::vector<uint32_t> found;
+        auto offer = [&](uint32_t wordNo, int score) {
+            if (best[wordNo] == NO_MATCH) found.push_back(wordNo);
+            if (score < best[wordNo]) best[wordNo] = static_cast<uint8_t>(score);
+        };
+
+        for (auto it = vocabulary.lower_bound(term);
+             it != vocabulary.end() && it->first.compare(0, term.size(), term) == 0; ++it) {
+            offer(it->second, it->first.size() == term.size() ? 0 : 1);
+        }
+
+        int k = std::min(maxDistance, static_cast<int>(term.size() / 4));
+        if (k > 0) {
+            // A word within distance k shares all but at most 4k of the
+            // term's distinct trigrams (a swap touches four, other edits three)
+            std::vector<uint32_t> grams = trigrams(term);
+            int needed = static_cast<int>(grams.size()) - 4 * k;
+            std::vector<uint16_t> shared(words.size(), 0);
+            std::vector<uint32_t> touched;
+            for (uint32_t gram : grams) {
+                auto it = trigramWords.find(gram);
+                if (it == trigramWords.end()) continue;
+                for (uint32_t wordNo : it->second) {
+                    if (shared[wordNo]++ == 0) touched.push_back(wordNo);
+                }
+            }
+
+            for (uint32_t wordNo : touched) {
+                if (shared[wordNo] < needed) continue;
+                int distance = boundedEditDistance(term, *words[wordNo], k);
+                if (distance > 0 && distance <= k) offer(wordNo, 2 * distance);
+            }
+        }
+
+        matches.clear();
+        for (uint32_t wordNo : found) matches.push_back({wordNo, best[wordNo]});
+        std::sort(matches.begin(), matches.end(),
+                  [](const WordMatch& a, const WordMatch& b) { return a.score < b.score; });
+    }
+
+    // Edit distance counting insertions, deletions, substitutions and
+    // swaps of neighbouring letters ("jonh" -> "john" is 1), or k + 1 as
+    // soon as it must exceed k
+    static int boundedEditDistance(const std::string& a, const std::string& b, int k) {
+        int lengthGap = static_cast<int>(a.size()) - static_cast<int>(b.size());
+        if (lengthGap > k || -lengthGap > k) return k + 1;
+
+        std::vector<int> older(b.size() + 1), prev(b.size() + 1), cur(b.size() + 1);
+        for (size_t j = 0; j <= b.size(); ++j) prev[j] = static_cast<int>(j);
+        for (size_t i = 1; i <= a.size(); ++i) {
+            cur[0] = static_cast<int>(i);
+            int rowMin = cur[0];
+            for (size_t j = 1; j <= b.size(); ++j) {
+                int substitute = prev[j - 1] + (a[i - 1] != b[j - 1]);
+                cur[j] = std::min({prev[j] + 1, cur[j - 1] + 1, substitute});
+                if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+                    cur[j] = std::min(cur[j], older[j - 2] + 1);
+                }
+                rowMin = std::min(rowMin, cur[j]);
+            }
+            if (rowMin > k) return k + 1;
+            std::swap(older, prev);
+            std::swap(prev, cur);
+        }
+        return prev[b.size()];
+    }
+
+    std::map<std::string, uint32_t> vocabulary;              // Word -> word number
+    std::vector<const std::string*> words;                   // Word number -> word
+    std::vector<std::vector<uint32_t>> postings;             // Word number -> record numbers
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigramWords;  // Trigram -> word numbers
+    std::vector<std::vector<uint32_t>> recordWords;          // Record number -> word numbers
+    size_t records = 0;
+};
+
+#endif
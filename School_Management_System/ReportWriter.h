@@ -0,0 +1,208 @@
+#ifndef REPORT_WRITER_H
+#define REPORT_WRITER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Shared output layer for long listings and reports.
+//
+// Text is formatted into one large buffer that is reused for the whole
+// listing and written to stdout (or a file) in big chunks, instead of going
+// through cout and the locale machinery one field at a time.
+//
+//   ReportWriter out;                  // stdout
+//   out << "ID: " << id << "\n";
+//   out.padRight(name, 15).fixed(average, 1) << "\n";
+//
+// Everything left in the buffer is written when the writer is destroyed.
+class ReportWriter {
+public:
+    static const size_t BUFFER_SIZE = 1 << 20;
+
+    // Write to stdout. Anything already sent to cout goes out first, so the
+    // listing appears after the text printed before it.
+    ReportWriter() : out(stdout), ownsFile(false), buffer(new char[BUFFER_SIZE]) {
+        std::cout.flush();
+    }
+
+    // Write to a file (check isOpen() afterwards)
+    explicit ReportWriter(const std::string& path)
+        : out(std::fopen(path.c_str(), "wb")), ownsFile(true), buffer(new char[BUFFER_SIZE]) {}
+
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+
+    ~ReportWriter() { close(); }
+
+    // Finish the current output and continue in a new file, keeping the
+    // buffer (for writing many small files). False if it can't be opened.
+    bool reopen(const std::string& path) {
+        close();
+        out = std::fopen(path.c_str(), "wb");
+        ownsFile = true;
+        failed = false;
+        return out != nullptr;
+    }
+
+    bool isOpen() const { return out != nullptr; }
+
+    // False if any write failed
+    bool good() const { return !failed; }
+
+    ReportWriter& operator<<(std::string_view text) {
+        append(text.data(), text.size());
+        return *this;
+    }
+
+    ReportWriter& operator<<(const char* text) {
+        append(text, std::strlen(text));
+        return *this;
+    }
+
+    ReportWriter& operator<<(const std::string& text) {
+        append(text.data(), text.size());
+        return *this;
+    }
+
+    ReportWriter& operator<<(char ch) {
+        if (used == BUFFER_SIZE) flush();
+        buffer[used++] = ch;
+        return *this;
+    }
+
+    // Integers, formatted without locale lookups
+    template <typename T,
+              typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value &&
+                                      !std::is_same<T, bool>::value, int>::type = 0>
+    ReportWriter& operator<<(T value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        append(digits, result.ptr - digits);
+        return *this;
+    }
+
+    // A floating-point value with a fixed number of decimals
+    ReportWriter& fixed(double value, int decimals) {
+        char digits[64];
+        append(digits, formatFixed(digits, value, decimals));
+        return *this;
+    }
+
+    // Text padded with spaces to at least width characters (like left << setw)
+    ReportWriter& padRight(std::string_view text, size_t width) {
+        append(text.data(), text.size());
+        for (size_t i = text.size(); i < width; ++i) *this << ' ';
+        return *this;
+    }
+
+    // A floating-point value padded to width characters
+    ReportWriter& padRight(double value, int decimals, size_t width) {
+        char digits[64];
+        return padRight(std::string_view(digits, formatFixed(digits, value, decimals)), width);
+    }
+
+    // Hand everything buffered so far to the OS
+    void flush() {
+        if (used > 0 && out) {
+            if (std::fwrite(buffer.get(), 1, used, out) != used) failed = true;
+            std::fflush(out);
+        }
+        used = 0;
+    }
+
+    void close() {
+        flush();
+        if (ownsFile && out) {
+            if (std::fclose(out) != 0) failed = true;
+        }
+        out = nullptr;
+    }
+
+private:
+    // Format value with snprintf into digits[64] and return the length
+    // written. snprintf returns the length it would have needed, so huge
+    // values are cut off at the buffer.
+    static size_t formatFixed(char (&digits)[64], double value, int decimals) {
+        int len = std::snprintf(digits, sizeof(digits), "%.*f", decimals, value);
+        return len > 0 ? std::min<size_t>(static_cast<size_t>(len), sizeof(digits) - 1) : 0;
+    }
+
+    void append(const char* data, size_t len) {
+        if (len >= BUFFER_SIZE) {
+            // Too big to buffer, write it straight through
+            flush();
+            if (out && std::fwrite(data, 1, len, out) != len) failed = true;
+            return;
+        }
+        if (used + len > BUFFER_SIZE) flush();
+        std::memcpy(buffer.get() + used, data, len);
+        used += len;
+    }
+
+    std::FILE* out;
+    bool ownsFile;
+    bool failed = false;
+    std::unique_ptr<char[]> buffer;
+    size_t used = 0;
+};
+
+// Rows [first, first + count) of a listing, for paging through large
+// listings. A count of 0 means "through the last row".
+struct RowRange {
+    // Listings longer than this ask which rows to show
+    static const size_t PROMPT_ROWS = 100;
+
+    size_t first = 0;
+    size_t count = 0;
+
+    size_t begin(size_t total) const { return std::min(first, total); }
+
+    size_t end(size_t total) const {
+        if (count == 0 || count > total - begin(total)) return total;
+        return begin(total) + count;
+    }
+
+    // For listings whose length is not known up front
+    bool contains(size_t row) const {
+        return row >= first && (count == 0 || row - first < count);
+    }
+
+    // Parse "first count" (1-based first row, as shown to the user) or an
+    // empty line for everything. Returns false if the text is not valid.
+    static bool parse(const std::string& text, RowRange& range) {
+        range = RowRange();
+        size_t firstRow = 0, rowCount = 0;
+        char extra;
+        if (text.find_first_not_of(" \t\r") == std::string::npos) return true;
+        int fields = std::sscanf(text.c_str(), "%zu %zu %c", &firstRow, &rowCount, &extra);
+        if (fields < 1 || fields > 2 || firstRow == 0) return false;
+        range.first = firstRow - 1;
+        range.count = fields == 2 ? rowCount : 0;
+        return true;
+    }
+
+    // Ask for a range on stdin when a listing is long; short listings show
+    // everything. Reads a whole line, so any newline left behind by an
+    // earlier "cin >> x" must be skipped first.
+    static RowRange prompt(size_t total) {
+        RowRange range;
+        if (total <= PROMPT_ROWS) return range;
+
+        std::string text;
+        std::cout << total << " rows. Rows to show (first count, Enter for all): ";
+        std::getline(std::cin, text);
+        if (!parse(text, range)) {
+            std::cout << "Invalid range, showing all rows.\n";
+        }
+        return range;
+    }
+};
+
+#endif
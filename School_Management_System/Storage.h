@@ -0,0 +1,280 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#define fsync _commit
+#define ftruncate _chsize
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+// File helpers shared by the programs that keep data on disk: whole-file
+// mappings, full writes and checksums for journals and headers.
+
+// CRC-32 (IEEE 802.3), used to find torn or damaged records.
+// Works through eight bytes per step with eight lookup tables
+// (slicing-by-8), which keeps checksumming large snapshots cheap.
+inline uint32_t crc32(const char* data, size_t len) {
+    struct Tables {
+        uint32_t table[8][256];
+        Tables() {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                table[0][i] = c;
+            }
+            for (int slice = 1; slice < 8; ++slice) {
+                for (uint32_t i = 0; i < 256; ++i) {
+                    uint32_t prev = table[slice - 1][i];
+                    table[slice][i] = (prev >> 8) ^ table[0][prev & 0xFF];
+                }
+            }
+        }
+    };
+    static const Tables tables;
+    const uint32_t (*t)[256] = tables.table;
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    uint32_t crc = 0xFFFFFFFFu;
+    for (; len >= 8; p += 8, len -= 8) {
+        uint32_t low = (p[0] | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24)) ^ crc;
+        uint32_t high = p[4] | (uint32_t(p[5]) << 8) | (uint32_t(p[6]) << 16) | (uint32_t(p[7]) << 24);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+    }
+    for (; len > 0; --len) {
+        crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Write all of data to a descriptor (false on any error)
+inline bool writeAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        auto written = ::write(fd, data, static_cast<unsigned>(len));
+        if (written <= 0) return false;
+        data += written;
+        len -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// View of a whole file.
+// Uses mmap where available (pages are loaded lazily by the OS),
+// otherwise falls back to a single bulk read. A private mapping can be
+// written to; the changes stay in memory and never reach the file.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& path, bool writablePrivate = false) {
+        close();
+#if !defined(_WIN32)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        len = static_cast<size_t>(st.st_size);
+        if (len > 0) {
+            int protection = writablePrivate ? PROT_READ | PROT_WRITE : PROT_READ;
+            void* p = mmap(nullptr, len, protection, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                len = 0;
+                return false;
+            }
+            ptr = static_cast<char*>(p);
+            mapped = true;
+        }
+        ::close(fd);  // The mapping stays valid after the descriptor is closed
+        return true;
+#else
+        (void)writablePrivate;  // The buffer is always writable
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        buffer.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(buffer.data(), buffer.size());
+        ptr = buffer.data();
+        len = buffer.size();
+        return true;
+#endif
+    }
+
+    void close() {
+#if !defined(_WIN32)
+        if (mapped) munmap(ptr, len);
+#endif
+        buffer.clear();
+        ptr = nullptr;
+        len = 0;
+        mapped = false;
+    }
+
+    const char* data() const { return ptr; }
+    size_t size() const { return len; }
+
+    // Only for files opened with writablePrivate
+    char* writableData() { return ptr; }
+
+private:
+    char* ptr = nullptr;
+    size_t len = 0;
+    bool mapped = false;
+    std::vector<char> buffer;
+};
+
+// Append-only log of checksummed records, for programs that save each
+// change as it happens and fold the log into a snapshot now and then.
+//
+// Record: uint32 payload length, uint32 CRC-32 of the payload, payload.
+// What a payload holds is up to the caller. Every record reaches the OS as
+// soon as it is appended (safe against a process crash); the fsync is
+// batched with its neighbours (group commit). Appends may come from several
+// threads.
+class Journal {
+public:
+    // Gets each intact payload during replay. Returning false treats the
+    // record as torn: replay stops and the log is cut off there.
+    using ApplyFn = std::function<bool(const char* payload, size_t length)>;
+
+    // fsync once this many records are waiting, or once the oldest waiting
+    // record is this old, whichever comes first
+    size_t groupCommitRecords = 64;
+    std::chrono::milliseconds groupCommitInterval{50};
+
+    Journal() = default;
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+    ~Journal() { close(); }
+
+    // Replay every intact record through apply(), then open the log for
+    // appending. A torn record at the end (crash during a write) and
+    // anything after it is cut off.
+    bool open(const std::string& path, const ApplyFn& apply) {
+        close();
+
+        size_t validLength = 0;
+        {
+            MappedFile file;
+            if (file.open(path)) validLength = replay(file.data(), file.size(), apply);
+        }
+
+        std::lock_guard<std::mutex> lock(writeLock);
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_BINARY, 0644);
+        if (fd < 0) return false;
+        if (ftruncate(fd, validLength) != 0) {
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        bytes = validLength;
+        return true;
+    }
+
+    // Append one record
+    bool append(const char* payload, size_t length) {
+        std::lock_guard<std::mutex> lock(writeLock);
+        if (fd < 0) return false;
+
+        uint32_t header[2] = {static_cast<uint32_t>(length), crc32(payload, length)};
+        record.assign(reinterpret_cast<const char*>(header), sizeof(header));
+        record.append(payload, length);
+        if (!writeAll(fd, record.data(), record.size())) return false;
+        bytes += record.size();
+
+        if (pending++ == 0) oldestPending = std::chrono::steady_clock::now();
+        if (pending >= groupCommitRecords ||
+            std::chrono::steady_clock::now() - oldestPending >= groupCommitInterval) {
+            return syncLocked();
+        }
+        return true;
+    }
+
+    bool append(const std::string& payload) { return append(payload.data(), payload.size()); }
+
+    // Force all appended records to stable storage
+    bool sync() {
+        std::lock_guard<std::mutex> lock(writeLock);
+        return syncLocked();
+    }
+
+    // Drop every record (after they were folded into a snapshot)
+    bool reset() {
+        std::lock_guard<std::mutex> lock(writeLock);
+        if (fd < 0) return false;
+        pending = 0;
+        bytes = 0;
+        return ftruncate(fd, 0) == 0 && fsync(fd) == 0;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(writeLock);
+        if (fd < 0) return;
+        syncLocked();
+        ::close(fd);
+        fd = -1;
+        pending = 0;
+    }
+
+    bool isOpen() const { return fd >= 0; }
+    size_t size() const { return bytes; }
+
+private:
+    bool syncLocked() {
+        if (fd < 0 || pending == 0) return true;
+        pending = 0;
+        return fsync(fd) == 0;
+    }
+
+    // Returns the length of the intact prefix of the log
+    static size_t replay(const char* data, size_t size, const ApplyFn& apply) {
+        size_t offset = 0;
+        while (size - offset >= 8) {
+            uint32_t header[2];
+            std::memcpy(header, data + offset, sizeof(header));
+            if (header[0] > size - offset - 8) break;
+
+            const char* payload = data + offset + 8;
+            if (crc32(payload, header[0]) != header[1] || !apply(payload, header[0])) break;
+            offset += 8 + header[0];
+        }
+        return offset;
+    }
+
+    std::mutex writeLock;
+    int fd = -1;
+    size_t bytes = 0;
+    size_t pending = 0;  // Records not yet synced
+    std::chrono::steady_clock::time_point oldestPending;
+    std::string record;  // Reused for every append
+};
+
+#endif
@@ -3,7 +3,24 @@
 #include <string>
 #include <fstream>
 #include <algorithm>
-#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <deque>
+#include <random>
+
+#include "NameSearchIndex.h"
+#include "ReportWriter.h"
+#include "Storage.h"
 
 using namespace std;
 
@@ -11,82 +28,421 @@ using namespace std;
 struct Course {
     string courseID;
     string courseName;
+    uint32_t capacity = 0;  // Maximum number of students, 0 = unlimited
+
+    // Tags the capacity field in the text format, so a course name that
+    // happens to end in "|<number>" is never read as a capacity
+    static constexpr string_view CAPACITY_TAG = "cap=";
 
     // For saving to file: convert course to string format
+    // (the capacity is only written when there is one, as "|cap=<n>")
     string toString() const {
-        return courseID + "|" + courseName;
+        string result = courseID + "|" + courseName;
+        if (capacity > 0) result += "|" + string(CAPACITY_TAG) + to_string(capacity);
+        return result;
     }
 
     // For loading from file: parse string into course
-    static Course fromString(const string& str) {
+    static Course fromString(string_view str) {
         Course c;
         size_t pos = str.find('|');
-        if (pos != string::npos) {
-            c.courseID = str.substr(0, pos);
-            c.courseName = str.substr(pos + 1);
+        if (pos != string_view::npos) {
+            c.courseID = string(str.substr(0, pos));
+            string_view rest = str.substr(pos + 1);
+
+            // Optional trailing "|cap=<capacity>"
+            size_t last = rest.rfind('|');
+            if (last != string_view::npos) {
+                string_view field = rest.substr(last + 1);
+                if (field.substr(0, CAPACITY_TAG.size()) == CAPACITY_TAG &&
+                    parseCapacity(field.substr(CAPACITY_TAG.size()), c.capacity)) {
+                    rest = rest.substr(0, last);
+                }
+            }
+            c.courseName = string(rest);
         }
         return c;
     }
+
+    // Parse a capacity: digits only, must fit in 32 bits
+    static bool parseCapacity(string_view str, uint32_t& out) {
+        if (str.empty() || str.size() > 9) return false;
+        uint32_t value = 0;
+        for (char ch : str) {
+            if (ch < '0' || ch > '9') return false;
+            value = value * 10 + (ch - '0');
+        }
+        out = value;
+        return true;
+    }
 };
 
+// Course IDs are interned: each distinct ID gets a dense integer handle,
+// and students store handles instead of copies of the ID strings.
+using CourseHandle = uint32_t;
+
 // Structure to represent a Student
 struct Student {
     string studentID;
     string name;
-    vector<string> enrolledCourses;  // Stores only course IDs
+    vector<CourseHandle> enrolledCourses;  // Sorted handles of the course IDs
 
-    // Convert student to string for file saving
-    string toString() const {
+    bool isEnrolled(CourseHandle course) const {
+        return binary_search(enrolledCourses.begin(), enrolledCourses.end(), course);
+    }
+
+    // Insert a course handle, keeping the set sorted (false if already there)
+    bool enroll(CourseHandle course) {
+        auto it = lower_bound(enrolledCourses.begin(), enrolledCourses.end(), course);
+        if (it != enrolledCourses.end() && *it == course) return false;
+        enrolledCourses.insert(it, course);
+        return true;
+    }
+
+    // Convert student to string for file saving (courseIDs: handle -> ID)
+    string toString(const vector<string>& courseIDs) const {
         string result = studentID + "|" + name;
-        for (const auto& courseID : enrolledCourses) {
-            result += "|" + courseID;
+        for (CourseHandle course : enrolledCourses) {
+            result += "|" + courseIDs[course];
         }
         return result;
     }
 
-    // Parse string and load into student object
-    static Student fromString(const string& str) {
+    // Parse string and load into student object.
+    // Fields are sliced straight out of the line; a trailing '|' does not
+    // start another (empty) field, the same as getline(ss, token, '|').
+    // intern(string_view) turns each course ID into a handle; the handles
+    // are left unsorted.
+    template <typename Intern>
+    static Student fromString(string_view str, Intern&& intern) {
         Student s;
-        stringstream ss(str);
-        string token;
-        vector<string> tokens;
+        if (!str.empty() && str.back() == '|') str.remove_suffix(1);
 
-        while (getline(ss, token, '|')) {
-            tokens.push_back(token);
+        size_t idEnd = str.find('|');
+        if (idEnd == string_view::npos) {
+            return s;  // Fewer than two fields
         }
+        size_t nameEnd = str.find('|', idEnd + 1);
+        s.studentID = string(str.substr(0, idEnd));
+        s.name = string(str.substr(idEnd + 1, nameEnd - idEnd - 1));
 
-        if (tokens.size() >= 2) {
-            s.studentID = tokens[0];
-            s.name = tokens[1];
-            for (size_t i = 2; i < tokens.size(); ++i) {
-                s.enrolledCourses.push_back(tokens[i]);
-            }
+        while (nameEnd != string_view::npos) {
+            size_t next = str.find('|', nameEnd + 1);
+            s.enrolledCourses.push_back(intern(str.substr(nameEnd + 1, next - nameEnd - 1)));
+            nameEnd = next;
         }
         return s;
     }
 };
 
+// ===== Binary snapshot format =====
+// Optional alternative to the text file. Everything is fixed-width so the
+// file can be mapped and used in place without parsing:
+//
+//   SnapshotHeader
+//   SnapshotCourse   courses[courseCount]
+//   SnapshotStudent  students[studentCount]
+//   uint32_t         enrollments[enrollmentCount]  (course table indexes)
+//   char             stringPool[stringPoolSize]    (IDs and names, no '\0')
+//
+// Integers are stored in the byte order of the machine that wrote the file;
+// the endian marker in the header rejects files from the other byte order.
+
+const char SNAPSHOT_MAGIC[8] = {'S', 'E', 'N', 'R', 'O', 'L', 'L', '1'};
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t SNAPSHOT_ENDIAN_MARK = 0x01020304;
+
+// Course rows that only exist because a student is enrolled in an ID with no
+// course record (the text format allows this); they are not real courses.
+const uint32_t COURSE_PLACEHOLDER = 1;
+
+struct StrRef {
+    uint32_t offset;  // Into the string pool
+    uint32_t length;
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianMark;
+    uint64_t courseCount;
+    uint64_t studentCount;
+    uint64_t enrollmentCount;
+    uint64_t stringPoolSize;
+    uint64_t courseOffset;
+    uint64_t studentOffset;
+    uint64_t enrollmentOffset;
+    uint64_t stringPoolOffset;
+};
+
+struct SnapshotCourse {
+    StrRef id;
+    StrRef name;
+    uint32_t flags;
+    uint32_t capacity;  // 0 = unlimited
+};
+
+struct SnapshotStudent {
+    StrRef id;
+    StrRef name;
+    uint64_t firstEnrollment;  // Into the enrollment array
+    uint32_t enrollmentCount;
+    uint32_t reserved;
+};
+
+// Lazily opened snapshot: open() only maps the file and checks the header,
+// records are read straight from the mapping when they are asked for.
+class SnapshotView {
+public:
+    bool open(const string& path) {
+        if (!file.open(path)) return false;
+        if (file.size() < sizeof(SnapshotHeader)) return false;
+
+        memcpy(&header, file.data(), sizeof(header));
+        if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+            header.version != SNAPSHOT_VERSION ||
+            header.endianMark != SNAPSHOT_ENDIAN_MARK) {
+            return false;
+        }
+
+        // Every table must lie inside the file, aligned for its records
+        // (they are read in place)
+        return fits(header.courseOffset, header.courseCount, sizeof(SnapshotCourse)) &&
+               fits(header.studentOffset, header.studentCount, sizeof(SnapshotStudent)) &&
+               fits(header.enrollmentOffset, header.enrollmentCount, sizeof(uint32_t)) &&
+               fits(header.stringPoolOffset, header.stringPoolSize, 1) &&
+               header.courseOffset % alignof(SnapshotCourse) == 0 &&
+               header.studentOffset % alignof(SnapshotStudent) == 0 &&
+               header.enrollmentOffset % alignof(uint32_t) == 0;
+    }
+
+    size_t courseCount() const { return header.courseCount; }
+    size_t studentCount() const { return header.studentCount; }
+    size_t enrollmentCount() const { return header.enrollmentCount; }
+
+    const SnapshotCourse& course(size_t i) const {
+        return reinterpret_cast<const SnapshotCourse*>(file.data() + header.courseOffset)[i];
+    }
+
+    const SnapshotStudent& student(size_t i) const {
+        return reinterpret_cast<const SnapshotStudent*>(file.data() + header.studentOffset)[i];
+    }
+
+    // A student's enrollments lie inside the enrollment array
+    bool enrollmentsFit(const SnapshotStudent& s) const {
+        return s.firstEnrollment <= header.enrollmentCount &&
+               s.enrollmentCount <= header.enrollmentCount - s.firstEnrollment;
+    }
+
+    // Course table index of the j-th enrollment of a student
+    // (only for students that pass enrollmentsFit)
+    uint32_t enrollment(const SnapshotStudent& s, size_t j) const {
+        return reinterpret_cast<const uint32_t*>(file.data() + header.enrollmentOffset)
+            [s.firstEnrollment + j];
+    }
+
+    // A string lies inside the string pool
+    bool strFits(StrRef ref) const {
+        return uint64_t(ref.offset) + ref.length <= header.stringPoolSize;
+    }
+
+    // (only for refs that pass strFits)
+    string_view str(StrRef ref) const {
+        return string_view(file.data() + header.stringPoolOffset + ref.offset, ref.length);
+    }
+
+private:
+    bool fits(uint64_t offset, uint64_t count, uint64_t width) const {
+        return offset <= file.size() && count <= (file.size() - offset) / width;
+    }
+
+    MappedFile file;
+    SnapshotHeader header = {};
+};
+
+// ===== Mutation journal =====
+// Every change is appended to the journal as one small record, so saving
+// costs O(change) instead of rewriting the whole data file. At startup the
+// journal is replayed on top of the last snapshot; compaction folds it into
+// a fresh snapshot and empties it again.
+//
+// Records are framed and checksummed by Journal (Storage.h).
+// Payload: one type byte, then two strings, each as uint32 length + bytes.
+
+const char JOURNAL_ADD_STUDENT = 'S';  // studentID, name
+const char JOURNAL_ADD_COURSE = 'C';   // courseID, courseName
+const char JOURNAL_ENROLL = 'E';       // studentID, courseID
+const char JOURNAL_CAPACITY = 'K';     // courseID, capacity in decimal
+
+// Payload of a journal record: the type byte, then both strings
+string journalPayload(char type, const string& first, const string& second) {
+    string payload(1, type);
+    for (const string* str : {&first, &second}) {
+        uint32_t len = static_cast<uint32_t>(str->size());
+        payload.append(reinterpret_cast<const char*>(&len), sizeof(len));
+        payload += *str;
+    }
+    return payload;
+}
+
+// Read one length-prefixed string of a payload (false if it runs past end)
+bool journalString(const char*& p, const char* end, string_view& out) {
+    uint32_t len;
+    if (end - p < static_cast<ptrdiff_t>(sizeof(len))) return false;
+    memcpy(&len, p, sizeof(len));
+    p += sizeof(len);
+    if (static_cast<size_t>(end - p) < len) return false;
+    out = string_view(p, len);
+    p += len;
+    return true;
+}
+
 // Global data: list of all students and available courses
 vector<Student> students;
 vector<Course> courses;
 const string DATA_FILE = "enrollment_data.txt";  // File for persistence
+// Binary snapshot; when present it is loaded instead of DATA_FILE
+const string SNAPSHOT_FILE = "enrollment_data.bin";
+bool snapshotInUse = false;  // Data came from SNAPSHOT_FILE, keep it updated
+const string JOURNAL_FILE = "enrollment_journal.log";
+const size_t JOURNAL_COMPACT_BYTES = 4 << 20;  // Fold into a snapshot past this size
+Journal journal;
+const size_t PARSE_CHUNK_MIN_BYTES = 1 << 20;  // Smaller files are parsed on one thread
+
+// Hash indexes: ID -> position in the vectors above.
+// Always updated together with the vectors, so lookups are O(1).
+unordered_map<string, size_t> studentIndex;
+// Name search: records are positions in students
+NameSearchIndex nameIndex;
+const size_t SEARCH_RESULTS = 10;  // Matches shown per name search
+
+// Course ID intern table, indexed by CourseHandle. A handle exists for every
+// course and for every ID a student is enrolled in, even without a course
+// record (the text format allows that).
+const size_t NO_COURSE = SIZE_MAX;
+vector<string> courseIDs;                          // Handle -> course ID
+unordered_map<string, CourseHandle> courseHandles; // Course ID -> handle
+vector<size_t> courseSlots;                        // Handle -> position in courses, or NO_COURSE
+
+// Per-course enrollment state, indexed by CourseHandle. A deque keeps
+// references valid while courses are added. Seats are claimed with a
+// compare-and-swap on seatsTaken, so the capacity check needs no lock and
+// can never overbook; the roster has its own lock, so enrollments in
+// different courses never wait for each other on the course side.
+struct CourseState {
+    atomic<uint32_t> seatsTaken{0};
+    mutex rosterLock;
+    vector<size_t> roster;  // Positions of enrolled students
+};
+deque<CourseState> courseStates;
+
+// Concurrency: enrollments (requestEnrollment/applyEnrollment) may run on
+// many threads at once and take registryMutex shared. Anything that adds
+// students or courses, changes a capacity or reads everything (saving)
+// takes it exclusively. A student's course set is guarded by one of a
+// fixed number of striped locks.
+shared_mutex registryMutex;
+const size_t STUDENT_LOCK_STRIPES = 256;
+mutex studentLocks[STUDENT_LOCK_STRIPES];
 
 // Function prototypes
+Student* findStudent(const string& studentID);
+const Course* findCourse(const string& courseID);
+CourseHandle internCourseID(string_view courseID);
+const Course* courseByHandle(CourseHandle course);
+bool registerStudent(Student s);
+bool registerCourse(Course c);
+bool loadTextData(const string& path);
+string_view nextLine(const char*& p, const char* end);
+
+// Students parsed from one chunk of the text file; their course handles
+// index courseIDs (views into the file buffer)
+struct ParsedChunk {
+    vector<Student> students;
+    vector<string_view> courseIDs;
+};
+void parseStudentChunk(const char* begin, const char* end, ParsedChunk& out);
+vector<ParsedChunk> parseStudentsParallel(const char* begin, const char* end);
+bool saveTextData(const string& path);
+bool loadSnapshot(const string& path);
+bool writeSnapshot(const string& path);
+bool fileExists(const string& path);
+bool writeSnapshotFiles();
+bool replayJournalRecord(const char* payload, size_t length);
+void compactIfNeeded();
 void loadData();
 void saveData();
 void displayMenu();
 void addStudent();
 void addCourse();
 void enrollStudent();
-void displayStudents();
-void displayCourses();
 
+enum class EnrollResult { Enrolled, StudentNotFound, CourseNotFound, AlreadyEnrolled, CourseFull };
+EnrollResult applyEnrollment(const string& studentID, const string& courseID);
+EnrollResult requestEnrollment(const string& studentID, const string& courseID);
+bool setCourseCapacity(const string& courseID, uint32_t capacity);
+int runStressTest(int threadCount);
+
+void displayStudents(RowRange range = RowRange());
+void displayCourses(RowRange range = RowRange());
+void displayCourseRoster();
+void searchStudents();
+int bulkImport(const string& source);
+void resetData();
+
+// Benchmark.cpp includes this file with SCHOOL_NO_MAIN defined
+#ifndef SCHOOL_NO_MAIN
 // Main function
-int main() {
+int main(int argc, char* argv[]) {
+    // Conversion between the text and the binary snapshot format:
+    //   --to-snapshot [text file] [snapshot file]
+    //   --to-text [snapshot file] [text file]
+    // Non-interactive bulk import of a CSV file ("-" reads stdin):
+    //   --import <file>
+    // Concurrent enrollment stress test (in memory, data files untouched):
+    //   --stress-test [threads]
+    if (argc >= 2) {
+        string mode = argv[1];
+        if (mode == "--stress-test") {
+            return runStressTest(argc >= 3 ? max(1, atoi(argv[2])) : 8);
+        }
+        if (mode == "--import") {
+            if (argc < 3) {
+                cout << "Usage: " << argv[0] << " --import <file.csv | ->\n";
+                return 1;
+            }
+            loadData();
+            return bulkImport(argv[2]);
+        }
+        if (mode == "--to-snapshot") {
+            string from = argc >= 3 ? argv[2] : DATA_FILE;
+            string to = argc >= 4 ? argv[3] : SNAPSHOT_FILE;
+            if (!loadTextData(from) || !writeSnapshot(to)) {
+                cout << "Error: Could not convert " << from << " to " << to << "\n";
+                return 1;
+            }
+            cout << "Converted " << from << " to " << to << "\n";
+            return 0;
+        }
+        if (mode == "--to-text") {
+            string from = argc >= 3 ? argv[2] : SNAPSHOT_FILE;
+            string to = argc >= 4 ? argv[3] : DATA_FILE;
+            if (!loadSnapshot(from) || !saveTextData(to)) {
+                cout << "Error: Could not convert " << from << " to " << to << "\n";
+                return 1;
+            }
+            cout << "Converted " << from << " to " << to << "\n";
+            return 0;
+        }
+        cout << "Unknown option: " << mode << "\n";
+        return 1;
+    }
+
     loadData();  // Load existing data from file at startup
 
     int choice;
     do {
+        journal.sync();  // Nothing typed so far is left unsynced while we wait
         displayMenu();
         cout << "Enter your choice: ";
         cin >> choice;
@@ -96,59 +452,311 @@ int main() {
             case 1: addStudent(); break;
             case 2: addCourse(); break;
             case 3: enrollStudent(); break;
-            case 4: displayStudents(); break;
-            case 5: displayCourses(); break;
-            case 6:
+            case 4: displayStudents(RowRange::prompt(students.size())); break;
+            case 5: displayCourses(RowRange::prompt(courses.size())); break;
+            case 6: displayCourseRoster(); break;
+            case 7: searchStudents(); break;
+            case 8:
                 saveData();
                 cout << "Data saved. Goodbye!\n";
                 break;
             default:
                 cout << "Invalid choice. Try again.\n";
         }
-    } while (choice != 6);
+    } while (choice != 8);
 
     return 0;
 }
+#endif
 
-// Load students and courses from file
-void loadData() {
-    ifstream file(DATA_FILE);
-    if (!file.is_open()) {
-        cout << "No previous data found. Starting fresh.\n";
-        return;
+// Look up a student by ID (nullptr if not registered)
+Student* findStudent(const string& studentID) {
+    auto it = studentIndex.find(studentID);
+    return it == studentIndex.end() ? nullptr : &students[it->second];
+}
+
+// Look up a course by ID (nullptr if not registered)
+const Course* findCourse(const string& courseID) {
+    auto it = courseHandles.find(courseID);
+    return it == courseHandles.end() ? nullptr : courseByHandle(it->second);
+}
+
+// Course record behind a handle (nullptr for IDs with no course record)
+const Course* courseByHandle(CourseHandle course) {
+    size_t slot = courseSlots[course];
+    return slot == NO_COURSE ? nullptr : &courses[slot];
+}
+
+// Return the handle of a course ID, creating one the first time it is seen.
+// Callers hold registryMutex exclusively, or run before other threads start.
+CourseHandle internCourseID(string_view courseID) {
+    auto it = courseHandles.find(string(courseID));
+    if (it != courseHandles.end()) {
+        return it->second;
     }
 
-    string line;
-    bool readingCourses = true;  // First section: courses, then students
+    CourseHandle course = static_cast<CourseHandle>(courseIDs.size());
+    courseIDs.emplace_back(courseID);
+    courseHandles.emplace(courseIDs.back(), course);
+    courseSlots.push_back(NO_COURSE);
+    courseStates.emplace_back();
+    return course;
+}
 
-    while (getline(file, line)) {
-        if (line.empty()) continue;
+// Add a student to the vector and the indexes (false if the ID is taken).
+// Any enrollments the student already has are added to the course rosters.
+bool registerStudent(Student s) {
+    unique_lock<shared_mutex> lock(registryMutex);
+    if (!studentIndex.emplace(s.studentID, students.size()).second) {
+        return false;
+    }
 
-        if (line == "---") {
-            readingCourses = false;  // Switch from courses to students
-            continue;
+    auto& enrolled = s.enrolledCourses;
+    sort(enrolled.begin(), enrolled.end());
+    enrolled.erase(unique(enrolled.begin(), enrolled.end()), enrolled.end());
+    for (CourseHandle course : enrolled) {
+        courseStates[course].roster.push_back(students.size());
+        courseStates[course].seatsTaken++;
+    }
+
+    nameIndex.add(static_cast<uint32_t>(students.size()), s.name);
+    students.push_back(move(s));
+    return true;
+}
+
+// Add a course to the vector and the index (false if the ID is taken)
+bool registerCourse(Course c) {
+    unique_lock<shared_mutex> lock(registryMutex);
+    CourseHandle course = internCourseID(c.courseID);
+    if (courseSlots[course] != NO_COURSE) {
+        return false;
+    }
+    courseSlots[course] = courses.size();
+    courses.push_back(move(c));
+    return true;
+}
+
+bool fileExists(const string& path) {
+    ifstream file(path);
+    return file.is_open();
+}
+
+// Load students and courses at startup, then replay the journal on top.
+// The binary snapshot takes precedence over the text file when it exists.
+void loadData() {
+    bool loaded = false;
+    if (fileExists(SNAPSHOT_FILE)) {
+        if (loadSnapshot(SNAPSHOT_FILE)) {
+            snapshotInUse = true;
+            loaded = true;
+            cout << "Data loaded successfully from " << SNAPSHOT_FILE << "\n";
+        } else {
+            cout << "Warning: " << SNAPSHOT_FILE << " is damaged, falling back to "
+                 << DATA_FILE << "\n";
+            resetData();
         }
+    }
 
-        if (readingCourses) {
-            Course c = Course::fromString(line);
-            courses.push_back(c);
+    if (!loaded) {
+        if (loadTextData(DATA_FILE)) {
+            cout << "Data loaded successfully from " << DATA_FILE << "\n";
         } else {
-            Student s = Student::fromString(line);
-            students.push_back(s);
+            cout << "No previous data found. Starting fresh.\n";
         }
     }
 
-    file.close();
-    cout << "Data loaded successfully from " << DATA_FILE << "\n";
+    if (!journal.open(JOURNAL_FILE, replayJournalRecord)) {
+        cout << "Warning: Could not open " << JOURNAL_FILE << ", changes will not be saved!\n";
+        return;
+    }
+    if (journal.size() > 0) {
+        cout << "Recovered unsaved changes from " << JOURNAL_FILE << "\n";
+    }
+    compactIfNeeded();
+}
+
+// Forget everything loaded (the journal is closed, files are untouched),
+// so loadData() can run again from scratch
+void resetData() {
+    journal.close();
+    unique_lock<shared_mutex> lock(registryMutex);
+    students.clear();
+    courses.clear();
+    studentIndex.clear();
+    nameIndex = NameSearchIndex();
+    courseIDs.clear();
+    courseHandles.clear();
+    courseSlots.clear();
+    courseStates.clear();
+    snapshotInUse = false;
 }
 
-// Save all students and courses to file
+// Make every change durable. Changes are already journaled as they happen,
+// so this only flushes the journal (and compacts it once it is large).
 void saveData() {
-    ofstream file(DATA_FILE);
-    if (!file.is_open()) {
+    if (!journal.sync()) {
         cout << "Error: Could not save data!\n";
         return;
     }
+    compactIfNeeded();
+    cout << "Data saved to " << JOURNAL_FILE << "\n";
+}
+
+// Apply one journal record during startup replay (false if it is malformed).
+// Replaying a record that is already part of the snapshot is harmless: every
+// change is an insert and duplicates are rejected.
+bool replayJournalRecord(const char* payload, size_t length) {
+    const char* p = payload;
+    const char* end = payload + length;
+    string_view first, second;
+    if (p == end) return false;
+    char type = *p++;
+    if (!journalString(p, end, first) || !journalString(p, end, second) || p != end) return false;
+
+    if (type == JOURNAL_ADD_STUDENT) {
+        Student s;
+        s.studentID = string(first);
+        s.name = string(second);
+        registerStudent(move(s));
+    } else if (type == JOURNAL_ADD_COURSE) {
+        Course c;
+        c.courseID = string(first);
+        c.courseName = string(second);
+        registerCourse(move(c));
+    } else if (type == JOURNAL_ENROLL) {
+        applyEnrollment(string(first), string(second));
+    } else if (type == JOURNAL_CAPACITY) {
+        uint32_t capacity;
+        if (Course::parseCapacity(second, capacity)) {
+            setCourseCapacity(string(first), capacity);
+        }
+    }
+    return true;
+}
+
+// Write the full data set: the text file, plus the binary snapshot if in use
+bool writeSnapshotFiles() {
+    if (!saveTextData(DATA_FILE)) return false;
+    return !snapshotInUse || writeSnapshot(SNAPSHOT_FILE);
+}
+
+// Fold the journal into a fresh snapshot once it has grown large.
+// The snapshot is complete before the journal is emptied, so a crash in
+// between only means the journal is replayed once more.
+void compactIfNeeded() {
+    if (!journal.isOpen() || journal.size() < JOURNAL_COMPACT_BYTES) return;
+
+    unique_lock<shared_mutex> lock(registryMutex);  // No changes while writing
+
+    if (!journal.sync() || !writeSnapshotFiles() || !journal.reset()) {
+        cout << "Warning: Could not compact " << JOURNAL_FILE << "\n";
+    }
+}
+
+// Load students and courses from the '|'-delimited text format
+bool loadTextData(const string& path) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    const char* p = file.data();
+    const char* end = p + file.size();
+
+    // First section: courses, up to the first "---" line
+    while (p < end) {
+        string_view line = nextLine(p, end);
+        if (line.empty()) continue;
+        if (line == "---") break;  // Switch from courses to students
+
+        // Records with a repeated ID are skipped: the first one wins,
+        // just like the old linear searches did
+        registerCourse(Course::fromString(line));
+    }
+
+    // Second section: students, parsed in parallel chunks.
+    // Each chunk numbers its course IDs privately; those local handles are
+    // mapped to global ones here, in file order.
+    vector<ParsedChunk> parts = parseStudentsParallel(p, end);
+    for (auto& part : parts) {
+        vector<CourseHandle> toGlobal;
+        toGlobal.reserve(part.courseIDs.size());
+        for (string_view courseID : part.courseIDs) {
+            toGlobal.push_back(internCourseID(courseID));
+        }
+
+        for (auto& s : part.students) {
+            for (auto& course : s.enrolledCourses) {
+                course = toGlobal[course];
+            }
+            registerStudent(move(s));
+        }
+    }
+    return true;
+}
+
+// Return the line starting at p (without its '\n') and move p past it
+string_view nextLine(const char*& p, const char* end) {
+    const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+    const char* lineEnd = newline ? newline : end;
+    string_view line(p, lineEnd - p);
+    p = newline ? newline + 1 : end;
+    return line;
+}
+
+// Parse every student line in [begin, end). Course IDs get chunk-local
+// handles (indexes into out.courseIDs), so no shared state is touched.
+void parseStudentChunk(const char* begin, const char* end, ParsedChunk& out) {
+    unordered_map<string_view, CourseHandle> localHandles;
+    auto intern = [&](string_view courseID) {
+        auto inserted = localHandles.emplace(courseID, static_cast<CourseHandle>(out.courseIDs.size()));
+        if (inserted.second) out.courseIDs.push_back(courseID);
+        return inserted.first->second;
+    };
+
+    while (begin < end) {
+        string_view line = nextLine(begin, end);
+        if (line.empty() || line == "---") continue;
+        out.students.push_back(Student::fromString(line, intern));
+    }
+}
+
+// Split the student section at line boundaries and parse the chunks on
+// worker threads. Chunks come back in file order, so merging them in order
+// gives exactly the sequential result.
+vector<ParsedChunk> parseStudentsParallel(const char* begin, const char* end) {
+    size_t size = end - begin;
+    size_t threads = max(1u, thread::hardware_concurrency());
+    size_t chunks = min(threads, size / PARSE_CHUNK_MIN_BYTES + 1);
+
+    vector<const char*> bounds = {begin};
+    for (size_t i = 1; i < chunks; ++i) {
+        const char* cut = max(bounds.back(), begin + size * i / chunks);
+        const char* newline = static_cast<const char*>(memchr(cut, '\n', end - cut));
+        bounds.push_back(newline ? newline + 1 : end);
+    }
+    bounds.push_back(end);
+
+    vector<ParsedChunk> parts(chunks);
+    vector<thread> workers;
+    for (size_t i = 1; i < chunks; ++i) {
+        workers.emplace_back(parseStudentChunk, bounds[i], bounds[i + 1], ref(parts[i]));
+    }
+    parseStudentChunk(bounds[0], bounds[1], parts[0]);  // This thread takes the first chunk
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return parts;
+}
+
+// Save all students and courses in the '|'-delimited text format.
+// Written to a temporary file first and renamed over the old one.
+bool saveTextData(const string& path) {
+    string tmpPath = path + ".tmp";
+    ofstream file(tmpPath);
+    if (!file.is_open()) {
+        return false;
+    }
 
     // Save courses first
     for (const auto& c : courses) {
@@ -158,11 +766,144 @@ void saveData() {
 
     // Save students
     for (const auto& s : students) {
-        file << s.toString() << "\n";
+        file << s.toString(courseIDs) << "\n";
     }
 
     file.close();
-    cout << "Data saved to " << DATA_FILE << "\n";
+    if (file.fail() || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Materialize a binary snapshot into the global vectors and indexes.
+// False if the file is missing or damaged; the data may then be partly
+// loaded and must be reset (see loadData).
+bool loadSnapshot(const string& path) {
+    SnapshotView view;
+    if (!view.open(path)) {
+        return false;
+    }
+
+    // Check every reference before registering anything, so a corrupt file
+    // is refused before it is half loaded
+    for (size_t i = 0; i < view.courseCount(); ++i) {
+        const SnapshotCourse& row = view.course(i);
+        if (!view.strFits(row.id) || !view.strFits(row.name)) return false;
+    }
+    for (size_t i = 0; i < view.studentCount(); ++i) {
+        const SnapshotStudent& row = view.student(i);
+        if (!view.strFits(row.id) || !view.strFits(row.name) || !view.enrollmentsFit(row)) return false;
+        for (size_t j = 0; j < row.enrollmentCount; ++j) {
+            if (view.enrollment(row, j) >= view.courseCount()) return false;
+        }
+    }
+
+    // Intern every course table row first; enrollments refer to rows
+    vector<CourseHandle> rowHandles(view.courseCount());
+    courses.reserve(courses.size() + view.courseCount());
+    for (size_t i = 0; i < view.courseCount(); ++i) {
+        const SnapshotCourse& row = view.course(i);
+        rowHandles[i] = internCourseID(view.str(row.id));
+        if (row.flags & COURSE_PLACEHOLDER) continue;
+        Course c;
+        c.courseID = string(view.str(row.id));
+        c.courseName = string(view.str(row.name));
+        c.capacity = row.capacity;
+        if (!registerCourse(move(c))) return false;  // Repeated ID: corrupt file
+    }
+
+    students.reserve(students.size() + view.studentCount());
+    for (size_t i = 0; i < view.studentCount(); ++i) {
+        const SnapshotStudent& row = view.student(i);
+        Student s;
+        s.studentID = string(view.str(row.id));
+        s.name = string(view.str(row.name));
+        s.enrolledCourses.reserve(row.enrollmentCount);
+        for (size_t j = 0; j < row.enrollmentCount; ++j) {
+            s.enrolledCourses.push_back(rowHandles[view.enrollment(row, j)]);
+        }
+        if (!registerStudent(move(s))) return false;  // Repeated ID: corrupt file
+    }
+    return true;
+}
+
+// Write the global data as a binary snapshot.
+// The file is written next to the target and renamed over it, so a failed
+// write never destroys the previous snapshot.
+bool writeSnapshot(const string& path) {
+    string pool;
+    auto addString = [&pool](const string& str) {
+        StrRef ref = {static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(str.size())};
+        pool += str;
+        return ref;
+    };
+
+    // Real courses keep their positions; enrolled IDs without a course
+    // record get placeholder rows after them
+    vector<SnapshotCourse> courseRows;
+    vector<uint32_t> handleRows(courseIDs.size());
+    courseRows.reserve(courseIDs.size());
+    for (const auto& c : courses) {
+        handleRows[courseHandles[c.courseID]] = static_cast<uint32_t>(courseRows.size());
+        courseRows.push_back({addString(c.courseID), addString(c.courseName), 0, c.capacity});
+    }
+    for (CourseHandle course = 0; course < courseIDs.size(); ++course) {
+        if (courseSlots[course] != NO_COURSE) continue;
+        handleRows[course] = static_cast<uint32_t>(courseRows.size());
+        courseRows.push_back({addString(courseIDs[course]), {0, 0}, COURSE_PLACEHOLDER, 0});
+    }
+
+    vector<SnapshotStudent> studentRows;
+    vector<uint32_t> enrollments;
+    studentRows.reserve(students.size());
+    for (const auto& s : students) {
+        SnapshotStudent row = {addString(s.studentID), addString(s.name), enrollments.size(),
+                               static_cast<uint32_t>(s.enrolledCourses.size()), 0};
+        for (CourseHandle course : s.enrolledCourses) {
+            enrollments.push_back(handleRows[course]);
+        }
+        studentRows.push_back(row);
+    }
+
+    if (pool.size() > UINT32_MAX) {
+        return false;  // String offsets are 32-bit
+    }
+
+    SnapshotHeader header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.endianMark = SNAPSHOT_ENDIAN_MARK;
+    header.courseCount = courseRows.size();
+    header.studentCount = studentRows.size();
+    header.enrollmentCount = enrollments.size();
+    header.stringPoolSize = pool.size();
+    header.courseOffset = sizeof(SnapshotHeader);
+    header.studentOffset = header.courseOffset + courseRows.size() * sizeof(SnapshotCourse);
+    header.enrollmentOffset = header.studentOffset + studentRows.size() * sizeof(SnapshotStudent);
+    header.stringPoolOffset = header.enrollmentOffset + enrollments.size() * sizeof(uint32_t);
+
+    string tmpPath = path + ".tmp";
+    ofstream file(tmpPath, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(courseRows.data()),
+               courseRows.size() * sizeof(SnapshotCourse));
+    file.write(reinterpret_cast<const char*>(studentRows.data()),
+               studentRows.size() * sizeof(SnapshotStudent));
+    file.write(reinterpret_cast<const char*>(enrollments.data()),
+               enrollments.size() * sizeof(uint32_t));
+    file.write(pool.data(), pool.size());
+    file.close();
+
+    if (file.fail() || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
 }
 
 // Display main menu
@@ -173,7 +914,9 @@ void displayMenu() {
     cout << "3. Enroll Student in Course\n";
     cout << "4. Display All Students\n";
     cout << "5. Display All Courses\n";
-    cout << "6. Save and Exit\n";
+    cout << "6. Display Course Roster\n";
+    cout << "7. Search Students by Name\n";
+    cout << "8. Save and Exit\n";
     cout << "================================\n";
 }
 
@@ -186,14 +929,12 @@ void addStudent() {
     getline(cin, s.name);
 
     // Check for duplicate student ID
-    for (const auto& stu : students) {
-        if (stu.studentID == s.studentID) {
-            cout << "Student with this ID already exists!\n";
-            return;
-        }
+    if (!registerStudent(s)) {
+        cout << "Student with this ID already exists!\n";
+        return;
     }
-
-    students.push_back(s);
+    journal.append(journalPayload(JOURNAL_ADD_STUDENT, s.studentID, s.name));
+    compactIfNeeded();
     cout << "Student added successfully.\n";
 }
 
@@ -204,16 +945,24 @@ void addCourse() {
     getline(cin, c.courseID);
     cout << "Enter Course Name: ";
     getline(cin, c.courseName);
+    cout << "Enter Course Capacity (0 for unlimited): ";
+    string capacity;
+    getline(cin, capacity);
+    if (!capacity.empty() && !Course::parseCapacity(capacity, c.capacity)) {
+        cout << "Invalid capacity!\n";
+        return;
+    }
 
     // Check for duplicate course ID
-    for (const auto& course : courses) {
-        if (course.courseID == c.courseID) {
-            cout << "Course with this ID already exists!\n";
-            return;
-        }
+    if (!registerCourse(c)) {
+        cout << "Course with this ID already exists!\n";
+        return;
     }
-
-    courses.push_back(c);
+    journal.append(journalPayload(JOURNAL_ADD_COURSE, c.courseID, c.courseName));
+    if (c.capacity > 0) {
+        journal.append(journalPayload(JOURNAL_CAPACITY, c.courseID, to_string(c.capacity)));
+    }
+    compactIfNeeded();
     cout << "Course added successfully.\n";
 }
 
@@ -225,87 +974,510 @@ void enrollStudent() {
     cout << "Enter Course ID: ";
     getline(cin, courseID);
 
-    // Find student pointer
-    Student* studentPtr = nullptr;
-    for (auto& s : students) {
-        if (s.studentID == studentID) {
-            studentPtr = &s;
+    switch (requestEnrollment(studentID, courseID)) {
+        case EnrollResult::StudentNotFound:
+            cout << "Student not found!\n";
+            return;
+        case EnrollResult::CourseNotFound:
+            cout << "Course not found!\n";
+            return;
+        case EnrollResult::AlreadyEnrolled:
+            cout << "Student already enrolled in this course.\n";
+            return;
+        case EnrollResult::CourseFull:
+            cout << "Course is full!\n";
+            return;
+        case EnrollResult::Enrolled:
             break;
-        }
     }
 
-    if (!studentPtr) {
-        cout << "Student not found!\n";
-        return;
+    compactIfNeeded();
+    cout << "Student enrolled successfully in course " << courseID << ".\n";
+}
+
+// Enroll a student and journal the change. Safe to call from many threads.
+EnrollResult requestEnrollment(const string& studentID, const string& courseID) {
+    EnrollResult result = applyEnrollment(studentID, courseID);
+    if (result == EnrollResult::Enrolled) {
+        journal.append(journalPayload(JOURNAL_ENROLL, studentID, courseID));
+    }
+    return result;
+}
+
+// Enroll a student in a course without any console output.
+// Safe to call from many threads; never puts a course over its capacity.
+EnrollResult applyEnrollment(const string& studentID, const string& courseID) {
+    shared_lock<shared_mutex> registryLock(registryMutex);
+
+    // Find student pointer
+    auto studentIt = studentIndex.find(studentID);
+    if (studentIt == studentIndex.end()) {
+        return EnrollResult::StudentNotFound;
     }
 
     // Check if course exists
-    bool courseExists = false;
-    for (const auto& c : courses) {
-        if (c.courseID == courseID) {
-            courseExists = true;
-            break;
-        }
-    }
-    if (!courseExists) {
-        cout << "Course not found!\n";
-        return;
+    auto courseIt = courseHandles.find(courseID);
+    if (courseIt == courseHandles.end() || courseSlots[courseIt->second] == NO_COURSE) {
+        return EnrollResult::CourseNotFound;
     }
+    CourseHandle course = courseIt->second;
+    CourseState& state = courseStates[course];
+    uint32_t capacity = courses[courseSlots[course]].capacity;
 
-    // === YOUR ORIGINAL LOGIC ENHANCED WITH COMMENTS ===
-    // Check if student is already enrolled in the course
-    if (find(studentPtr->enrolledCourses.begin(), studentPtr->enrolledCourses.end(), courseID)
-        != studentPtr->enrolledCourses.end()) {
-        cout << "Student already enrolled in this course.\n";
-        return;
+    size_t studentPos = studentIt->second;
+    Student& student = students[studentPos];
+    lock_guard<mutex> studentLock(studentLocks[studentPos % STUDENT_LOCK_STRIPES]);
+
+    // Check if student is already enrolled in the course (binary search in
+    // the student's sorted handle set)
+    if (student.isEnrolled(course)) {
+        return EnrollResult::AlreadyEnrolled;
     }
-    // ==================================================
 
-    // If not enrolled, add the course
-    studentPtr->enrolledCourses.push_back(courseID);
-    cout << "Student enrolled successfully in course " << courseID << ".\n";
+    // Claim a seat; a failed compare-and-swap means another thread took
+    // one in the meantime, so look at the count again
+    uint32_t taken = state.seatsTaken.load();
+    do {
+        if (capacity > 0 && taken >= capacity) {
+            return EnrollResult::CourseFull;
+        }
+    } while (!state.seatsTaken.compare_exchange_weak(taken, taken + 1));
+
+    student.enroll(course);
+    lock_guard<mutex> rosterLock(state.rosterLock);
+    state.roster.push_back(studentPos);
+    return EnrollResult::Enrolled;
 }
 
-// Display all students and their enrolled courses
-void displayStudents() {
+// Change the capacity of a course (not journaled). Lowering it below the
+// current enrollment keeps everyone enrolled but admits no one new.
+bool setCourseCapacity(const string& courseID, uint32_t capacity) {
+    unique_lock<shared_mutex> lock(registryMutex);
+    auto it = courseHandles.find(courseID);
+    if (it == courseHandles.end() || courseSlots[it->second] == NO_COURSE) {
+        return false;
+    }
+    courses[courseSlots[it->second]].capacity = capacity;
+    return true;
+}
+
+// Display all students and their enrolled courses (or a range of them)
+void displayStudents(RowRange range) {
     if (students.empty()) {
         cout << "No students registered.\n";
         return;
     }
 
-    cout << "\n--- List of Students ---\n";
-    for (const auto& s : students) {
-        cout << "ID: " << s.studentID << ", Name: " << s.name << "\n";
-        cout << "  Enrolled Courses: ";
+    ReportWriter out;
+    out << "\n--- List of Students ---\n";
+    for (size_t pos = range.begin(students.size()); pos < range.end(students.size()); ++pos) {
+        const Student& s = students[pos];
+        out << "ID: " << s.studentID << ", Name: " << s.name << "\n";
+        out << "  Enrolled Courses: ";
         if (s.enrolledCourses.empty()) {
-            cout << "None";
+            out << "None";
         } else {
             for (size_t i = 0; i < s.enrolledCourses.size(); ++i) {
-                // Find course name by ID
-                string courseName = "Unknown";
-                for (const auto& c : courses) {
-                    if (c.courseID == s.enrolledCourses[i]) {
-                        courseName = c.courseName;
-                        break;
-                    }
-                }
-                cout << s.enrolledCourses[i] << " (" << courseName << ")";
-                if (i < s.enrolledCourses.size() - 1) cout << ", ";
+                // Find course name by handle
+                const Course* course = courseByHandle(s.enrolledCourses[i]);
+                out << courseIDs[s.enrolledCourses[i]] << " ("
+                    << (course ? string_view(course->courseName) : "Unknown") << ")";
+                if (i < s.enrolledCourses.size() - 1) out << ", ";
             }
         }
-        cout << "\n";
+        out << "\n";
     }
 }
 
-// Display all available courses
-void displayCourses() {
+// Display all available courses (or a range of them)
+void displayCourses(RowRange range) {
     if (courses.empty()) {
         cout << "No courses available.\n";
         return;
     }
 
-    cout << "\n--- List of Courses ---\n";
-    for (const auto& c : courses) {
-        cout << "ID: " << c.courseID << ", Name: " << c.courseName << "\n";
+    ReportWriter out;
+    out << "\n--- List of Courses ---\n";
+    for (size_t pos = range.begin(courses.size()); pos < range.end(courses.size()); ++pos) {
+        const Course& c = courses[pos];
+        out << "ID: " << c.courseID << ", Name: " << c.courseName
+            << ", Enrolled: " << courseStates[courseHandles[c.courseID]].roster.size();
+        if (c.capacity > 0) out << "/" << c.capacity;
+        out << "\n";
+    }
+}
+
+// Display the students enrolled in one course (walks only its roster)
+void displayCourseRoster() {
+    string courseID;
+    cout << "Enter Course ID: ";
+    getline(cin, courseID);
+
+    const Course* course = findCourse(courseID);
+    if (!course) {
+        cout << "Course not found!\n";
+        return;
+    }
+
+    const auto& roster = courseStates[courseHandles[courseID]].roster;
+    RowRange range = RowRange::prompt(roster.size());
+
+    ReportWriter out;
+    out << "\n--- Roster for " << course->courseID << " (" << course->courseName << ") ---\n";
+    for (size_t i = range.begin(roster.size()); i < range.end(roster.size()); ++i) {
+        const Student& s = students[roster[i]];
+        out << "ID: " << s.studentID << ", Name: " << s.name << "\n";
+    }
+    out << "Total enrolled: " << roster.size() << "\n";
+}
+
+// Find students by (part of) their name. Each word typed matches the start
+// of a name word ("jo ka" finds "John Kamau") or, for longer words, a name
+// word with a typo or two ("jonh" finds "John"). Best matches come first.
+void searchStudents() {
+    string query;
+    cout << "Enter name to search: ";
+    getline(cin, query);
+
+    vector<NameSearchIndex::Match> matches;
+    {
+        shared_lock<shared_mutex> lock(registryMutex);
+        matches = nameIndex.search(query, SEARCH_RESULTS);
+    }
+    if (matches.empty()) {
+        cout << "No matching students found.\n";
+        return;
+    }
+
+    ReportWriter out;
+    out << "\n--- Students matching \"" << query << "\" ---\n";
+    for (const auto& match : matches) {
+        const Student& s = students[match.id];
+        out << "ID: " << s.studentID << ", Name: " << s.name << "\n";
+    }
+}
+
+// ===== Bulk import =====
+// CSV rows, one record each ("#" lines and blank lines are ignored):
+//   student,<student ID>,<name>
+//   course,<course ID>,<course name>[,<capacity>]
+//   enroll,<student ID>,<course ID>
+// Fields may be double-quoted ("" inside quotes is a literal quote).
+//
+// Rows are processed in batches: each batch is validated against the
+// indexes (and the rows before it in the same batch), then the accepted
+// rows are applied in one pass without console output. Rejected rows are
+// reported with their line number and reason. At the end the data is
+// written as a fresh snapshot, which also empties the journal.
+
+const size_t IMPORT_BATCH_ROWS = 8192;
+
+struct ImportRow {
+    size_t line;
+    size_t fieldCount;  // 0 if a quote is left open
+    string type;
+    string first;
+    string second;
+    string capacity;  // Optional fourth field of course rows
+};
+
+// Split one CSV line into fields (false if a quote is left open)
+bool splitCsvLine(string_view line, vector<string>& fields) {
+    fields.clear();
+    string field;
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        char ch = line[i];
+        if (quoted) {
+            if (ch == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                field += '"';
+                ++i;
+            } else if (ch == '"') {
+                quoted = false;
+            } else {
+                field += ch;
+            }
+        } else if (ch == '"') {
+            quoted = true;
+        } else if (ch == ',') {
+            fields.push_back(move(field));
+            field.clear();
+        } else {
+            field += ch;
+        }
+    }
+    fields.push_back(move(field));
+    return !quoted;
+}
+
+// What the rows validated so far in the current batch will add
+struct ImportPending {
+    unordered_set<string> students;
+    unordered_map<string, uint32_t> courses;  // Course ID -> capacity
+    unordered_set<string> enrollments;        // studentID + '\0' + courseID
+    unordered_map<string, uint32_t> seats;    // Course ID -> seats claimed
+};
+
+// Check one row; returns the rejection reason, or nullptr if it is valid
+const char* validateImportRow(const ImportRow& row, ImportPending& pending) {
+    // The text format uses '|' and newlines as separators
+    auto storable = [](const string& str) {
+        return str.find_first_of("|\r\n") == string::npos;
+    };
+    if (row.fieldCount == 0) return "unclosed quote";
+    bool isCourse = row.type == "course";
+    if (!isCourse && row.type != "student" && row.type != "enroll") {
+        return "unknown record type, expected student, course or enroll";
+    }
+    if (isCourse && (row.fieldCount < 3 || row.fieldCount > 4)) return "course rows take 3 or 4 fields";
+    if (!isCourse && row.fieldCount != 3) {
+        return row.type == "student" ? "student rows take 3 fields" : "enroll rows take 3 fields";
+    }
+    uint32_t capacity = 0;
+    if (!row.capacity.empty() && !Course::parseCapacity(row.capacity, capacity)) {
+        return "invalid capacity";
+    }
+    if (row.first.empty()) return "empty ID";
+    if (!storable(row.first) || !storable(row.second)) return "field contains '|'";
+
+    if (row.type == "student") {
+        if (studentIndex.count(row.first) || !pending.students.insert(row.first).second) {
+            return "duplicate student ID";
+        }
+        return nullptr;
+    }
+    if (row.type == "course") {
+        if (findCourse(row.first) || !pending.courses.emplace(row.first, capacity).second) {
+            return "duplicate course ID";
+        }
+        return nullptr;
+    }
+    // An enroll row
+    auto studentIt = studentIndex.find(row.first);
+    if (studentIt == studentIndex.end() && !pending.students.count(row.first)) {
+        return "student not found";
+    }
+
+    auto courseIt = courseHandles.find(row.second);
+    bool courseExists = courseIt != courseHandles.end() && courseSlots[courseIt->second] != NO_COURSE;
+    uint32_t taken = 0;
+    if (courseExists) {
+        capacity = courses[courseSlots[courseIt->second]].capacity;
+        taken = courseStates[courseIt->second].seatsTaken;
+    } else {
+        auto pendingCourse = pending.courses.find(row.second);
+        if (pendingCourse == pending.courses.end()) {
+            return "course not found";
+        }
+        capacity = pendingCourse->second;
+    }
+
+    if (studentIt != studentIndex.end() && courseExists &&
+        students[studentIt->second].isEnrolled(courseIt->second)) {
+        return "already enrolled";
+    }
+    if (pending.enrollments.count(row.first + '\0' + row.second)) {
+        return "already enrolled";
+    }
+    uint32_t& seats = pending.seats[row.second];
+    if (capacity > 0 && taken + seats >= capacity) {
+        return "course full";
+    }
+    seats++;
+    pending.enrollments.insert(row.first + '\0' + row.second);
+    return nullptr;
+}
+
+// Validate a batch, report the rejects and apply the rest.
+// Returns the number of rows applied.
+size_t applyImportBatch(const vector<ImportRow>& batch) {
+    ImportPending pending;
+    vector<const ImportRow*> accepted;
+    accepted.reserve(batch.size());
+
+    for (const auto& row : batch) {
+        const char* reason = validateImportRow(row, pending);
+        if (reason) {
+            cout << "Line " << row.line << ": rejected (" << reason << ")\n";
+        } else {
+            accepted.push_back(&row);
+        }
+    }
+
+    for (const ImportRow* row : accepted) {
+        if (row->type == "student") {
+            Student s;
+            s.studentID = row->first;
+            s.name = row->second;
+            registerStudent(move(s));
+        } else if (row->type == "course") {
+            Course c;
+            c.courseID = row->first;
+            c.courseName = row->second;
+            if (!row->capacity.empty()) Course::parseCapacity(row->capacity, c.capacity);
+            registerCourse(move(c));
+        } else {
+            applyEnrollment(row->first, row->second);
+        }
     }
+    return accepted.size();
+}
+
+// Import a CSV file (or stdin for "-"); returns the process exit code
+int bulkImport(const string& source) {
+    auto started = chrono::steady_clock::now();
+
+    MappedFile file;
+    string input;
+    if (source == "-") {
+        char buffer[1 << 16];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), stdin)) > 0) {
+            input.append(buffer, n);
+        }
+    } else if (!file.open(source)) {
+        cout << "Error: Could not open " << source << "\n";
+        return 1;
+    }
+    const char* p = source == "-" ? input.data() : file.data();
+    const char* end = p + (source == "-" ? input.size() : file.size());
+
+    size_t lineNumber = 0, rows = 0, applied = 0;
+    vector<ImportRow> batch;
+    batch.reserve(IMPORT_BATCH_ROWS);
+    vector<string> fields;
+
+    while (p < end) {
+        string_view line = nextLine(p, end);
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty() || line[0] == '#') continue;
+
+        ++rows;
+        if (!splitCsvLine(line, fields)) {
+            batch.push_back({lineNumber, 0, "", "", "", ""});
+        } else {
+            size_t fieldCount = fields.size();
+            fields.resize(max<size_t>(fieldCount, 4));
+            batch.push_back({lineNumber, fieldCount, move(fields[0]), move(fields[1]),
+                             move(fields[2]), move(fields[3])});
+        }
+
+        if (batch.size() == IMPORT_BATCH_ROWS) {
+            applied += applyImportBatch(batch);
+            batch.clear();
+        }
+    }
+    applied += applyImportBatch(batch);
+
+    // One snapshot write instead of one journal record per row
+    bool saved = writeSnapshotFiles() && journal.reset();
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    cout << "Imported " << applied << " of " << rows << " rows (" << rows - applied
+         << " rejected) in " << seconds << " s, "
+         << static_cast<long long>(rows / max(seconds, 1e-9)) << " rows/s\n";
+    if (!saved) {
+        cout << "Error: Could not save data!\n";
+        return 1;
+    }
+    return 0;
+}
+
+// ===== Concurrent enrollment stress test =====
+// Builds an in-memory registry (no files are read or written), hammers
+// applyEnrollment() from many threads with a mix of popular, tiny courses
+// and unlimited ones, then checks the seat invariants:
+//   - no course holds more students than its capacity
+//   - seatsTaken == roster size == number of successful enrollments
+//   - rosters and students' course sets agree, with no duplicates
+// Returns the process exit code (0 when every invariant holds).
+int runStressTest(int threadCount) {
+    const int STUDENTS = 20000;
+    const int COURSES = 500;
+    const int POPULAR = 10;            // Small courses every thread fights over
+    const int REQUESTS_PER_THREAD = 200000;
+
+    mt19937 setupRng(12345);
+    for (int i = 0; i < COURSES; ++i) {
+        Course c;
+        c.courseID = "C" + to_string(i);
+        c.courseName = "Course " + to_string(i);
+        c.capacity = i < POPULAR ? 25 : (i % 5 == 0 ? 0 : 20 + setupRng() % 200);
+        registerCourse(move(c));
+    }
+    for (int i = 0; i < STUDENTS; ++i) {
+        Student s;
+        s.studentID = "S" + to_string(i);
+        s.name = "Student " + to_string(i);
+        registerStudent(move(s));
+    }
+
+    cout << "Stress test: " << threadCount << " threads x " << REQUESTS_PER_THREAD
+         << " enrollment requests, " << STUDENTS << " students, " << COURSES << " courses\n";
+
+    vector<vector<uint32_t>> successes(threadCount, vector<uint32_t>(COURSES, 0));
+    vector<thread> workers;
+    auto started = chrono::steady_clock::now();
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&, t]() {
+            mt19937 rng(1000 + t);
+            for (int i = 0; i < REQUESTS_PER_THREAD; ++i) {
+                int course = (rng() % 4 == 0) ? rng() % POPULAR : rng() % COURSES;
+                int student = rng() % STUDENTS;
+                if (applyEnrollment("S" + to_string(student), "C" + to_string(course)) ==
+                    EnrollResult::Enrolled) {
+                    successes[t][course]++;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+    // Check the invariants
+    size_t failures = 0;
+    size_t totalEnrolled = 0;
+    for (int i = 0; i < COURSES; ++i) {
+        CourseHandle course = courseHandles["C" + to_string(i)];
+        const CourseState& state = courseStates[course];
+        const Course& c = courses[courseSlots[course]];
+
+        uint32_t expected = 0;
+        for (int t = 0; t < threadCount; ++t) expected += successes[t][i];
+        totalEnrolled += expected;
+
+        vector<size_t> roster = state.roster;
+        sort(roster.begin(), roster.end());
+        bool duplicates = adjacent_find(roster.begin(), roster.end()) != roster.end();
+        bool mismatch = false;
+        for (size_t pos : roster) {
+            if (!students[pos].isEnrolled(course)) mismatch = true;
+        }
+
+        if ((c.capacity > 0 && roster.size() > c.capacity) || state.seatsTaken != roster.size() ||
+            roster.size() != expected || duplicates || mismatch) {
+            cout << "FAIL: " << c.courseID << " capacity " << c.capacity << ", roster "
+                 << roster.size() << ", seats " << state.seatsTaken << ", successes " << expected
+                 << (duplicates ? ", duplicate students" : "")
+                 << (mismatch ? ", roster/student mismatch" : "") << "\n";
+            failures++;
+        }
+    }
+
+    size_t studentSide = 0;
+    for (const auto& s : students) studentSide += s.enrolledCourses.size();
+    if (studentSide != totalEnrolled) {
+        cout << "FAIL: students hold " << studentSide << " enrollments, rosters hold "
+             << totalEnrolled << "\n";
+        failures++;
+    }
+
+    double requests = double(threadCount) * REQUESTS_PER_THREAD;
+    cout << totalEnrolled << " enrollments accepted in " << seconds << " s ("
+         << static_cast<long long>(requests / max(seconds, 1e-9)) << " requests/s)\n";
+    cout << (failures == 0 ? "PASS: all seat invariants hold\n" : "FAIL: invariants violated\n");
+    return failures == 0 ? 0 : 1;
 }
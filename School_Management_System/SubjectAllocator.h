@@ -0,0 +1,206 @@
+#ifndef SUBJECT_ALLOCATOR_H
+#define SUBJECT_ALLOCATOR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// What one student asks for: subjects in order of preference, and how many
+// of them the student should get
+struct SubjectPreferences {
+    std::vector<int> ranked;
+    int wanted = 0;
+};
+
+struct SubjectAllocation {
+    std::vector<std::vector<int>> assigned;  // Per student, in preference order
+    std::vector<int> filled;                 // Per subject
+    std::vector<int> missing;                // Per student: wanted minus assigned
+    std::vector<uint64_t> byRank;            // Assignments at each preference rank (0 = first choice)
+    uint64_t studentsShort = 0;              // Students with missing > 0
+    uint64_t placesShort = 0;                // Sum of missing
+    uint64_t cost = 0;                       // Sum of the ranks assigned
+    int phases = 0;                          // Shortest-path rounds the solver needed
+};
+
+// Assigns students to subjects as a min-cost flow:
+//
+//   source -> student   capacity wanted, cost 0
+//   student -> subject  capacity 1, cost = rank in the student's list
+//   subject -> sink     capacity = the subject's capacity, cost 0
+//
+// A maximum flow gives as many places as the capacities allow; of those,
+// the minimum cost one prefers higher-ranked choices. Only listed subjects
+// are ever assigned, so whatever is missing is an unmet preference.
+//
+// Solved primal-dual: Dijkstra over reduced costs finds the shortest
+// distances and updates the node potentials, then a blocking flow (Dinic)
+// saturates every shortest path at once through the zero-reduced-cost
+// edges. Path costs are small integers, so there are only a handful of
+// rounds even for tens of thousands of students.
+class SubjectAllocator {
+public:
+    // capacity[subject] < 0 means no limit
+    SubjectAllocation solve(const std::vector<int>& capacity,
+                            const std::vector<SubjectPreferences>& students) {
+        const int studentCount = static_cast<int>(students.size());
+        const int subjectCount = static_cast<int>(capacity.size());
+        source = 0;
+        sink = studentCount + subjectCount + 1;
+        graph.assign(sink + 1, std::vector<Edge>());
+
+        size_t maxRank = 0;
+        for (int s = 0; s < studentCount; ++s) {
+            const SubjectPreferences& prefs = students[s];
+            int wanted = std::min<int>(prefs.wanted, static_cast<int>(prefs.ranked.size()));
+            if (wanted > 0) addEdge(source, studentNode(s), wanted, 0);
+            for (size_t rank = 0; rank < prefs.ranked.size(); ++rank) {
+                int subject = prefs.ranked[rank];
+                if (subject < 0 || subject >= subjectCount) continue;
+                addEdge(studentNode(s), subjectNode(studentCount, subject), 1, static_cast<int64_t>(rank));
+                maxRank = std::max(maxRank, rank + 1);
+            }
+        }
+        for (int subject = 0; subject < subjectCount; ++subject) {
+            int cap = capacity[subject] < 0 ? studentCount : capacity[subject];
+            if (cap > 0) addEdge(subjectNode(studentCount, subject), sink, cap, 0);
+        }
+
+        SubjectAllocation result;
+        potential.assign(graph.size(), 0);  // Every cost starts non-negative
+        while (shortestPaths()) {
+            result.phases++;
+            while (levelGraph()) {
+                next.assign(graph.size(), 0);
+                while (augment(source, std::numeric_limits<int>::max()) > 0) {}
+            }
+        }
+
+        // Read the assignment off the saturated student -> subject edges
+        result.assigned.resize(studentCount);
+        result.filled.assign(subjectCount, 0);
+        result.missing.assign(studentCount, 0);
+        result.byRank.assign(maxRank, 0);
+        for (int s = 0; s < studentCount; ++s) {
+            for (const Edge& e : graph[studentNode(s)]) {
+                if (e.to == source || e.cap != 0) continue;  // The source's reverse edge, or unused
+                int subject = e.to - studentCount - 1;
+                result.assigned[s].push_back(subject);
+                result.filled[subject]++;
+                result.byRank[e.cost]++;
+                result.cost += e.cost;
+            }
+            result.missing[s] = std::max(0, students[s].wanted - static_cast<int>(result.assigned[s].size()));
+            if (result.missing[s] > 0) {
+                result.studentsShort++;
+                result.placesShort += result.missing[s];
+            }
+        }
+        return result;
+    }
+
+private:
+    struct Edge {
+        int to;
+        int rev;     // Index of the reverse edge in graph[to]
+        int cap;     // Residual capacity
+        int64_t cost;
+    };
+
+    static int studentNode(int student) { return student + 1; }
+    static int subjectNode(int studentCount, int subject) { return studentCount + 1 + subject; }
+
+    void addEdge(int from, int to, int cap, int64_t cost) {
+        graph[from].push_back({to, static_cast<int>(graph[to].size()), cap, cost});
+        graph[to].push_back({from, static_cast<int>(graph[from].size()) - 1, 0, -cost});
+    }
+
+    int64_t reducedCost(int from, const Edge& e) const {
+        return e.cost + potential[from] - potential[e.to];
+    }
+
+    // Dijkstra over reduced costs, then fold the distances into the
+    // potentials so that shortest-path edges have reduced cost 0.
+    // False once the sink can't be reached.
+    bool shortestPaths() {
+        const int64_t INF = std::numeric_limits<int64_t>::max();
+        std::vector<int64_t> dist(graph.size(), INF);
+        using Entry = std::pair<int64_t, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+        dist[source] = 0;
+        heap.push({0, source});
+        while (!heap.empty()) {
+            auto [d, node] = heap.top();
+            heap.pop();
+            if (d != dist[node]) continue;
+            for (const Edge& e : graph[node]) {
+                if (e.cap == 0) continue;
+                int64_t nd = d + reducedCost(node, e);
+                if (nd < dist[e.to]) {
+                    dist[e.to] = nd;
+                    heap.push({nd, e.to});
+                }
+            }
+        }
+        if (dist[sink] == INF) return false;
+
+        // Unreached nodes move by the largest distance, which keeps every
+        // residual edge's reduced cost non-negative
+        int64_t farthest = 0;
+        for (int64_t d : dist) {
+            if (d != INF) farthest = std::max(farthest, d);
+        }
+        for (size_t node = 0; node < graph.size(); ++node) {
+            potential[node] += dist[node] == INF ? farthest : dist[node];
+        }
+        return true;
+    }
+
+    // BFS levels over the admissible edges (residual, reduced cost 0)
+    bool levelGraph() {
+        level.assign(graph.size(), -1);
+        std::vector<int> queue = {source};
+        level[source] = 0;
+        for (size_t i = 0; i < queue.size(); ++i) {
+            int node = queue[i];
+            for (const Edge& e : graph[node]) {
+                if (e.cap > 0 && level[e.to] < 0 && reducedCost(node, e) == 0) {
+                    level[e.to] = level[node] + 1;
+                    queue.push_back(e.to);
+                }
+            }
+        }
+        return level[sink] >= 0;
+    }
+
+    // Push flow along one admissible path of the level graph. Paths never
+    // revisit a subject, so the recursion is at most about twice the number
+    // of subjects deep.
+    int augment(int node, int limit) {
+        if (node == sink) return limit;
+        for (int& i = next[node]; i < static_cast<int>(graph[node].size()); ++i) {
+            Edge& e = graph[node][i];
+            if (e.cap == 0 || level[e.to] != level[node] + 1 || reducedCost(node, e) != 0) continue;
+            int pushed = augment(e.to, std::min(limit, e.cap));
+            if (pushed > 0) {
+                e.cap -= pushed;
+                graph[e.to][e.rev].cap += pushed;
+                return pushed;
+            }
+        }
+        return 0;
+    }
+
+    std::vector<std::vector<Edge>> graph;
+    std::vector<int64_t> potential;
+    std::vector<int> level;
+    std::vector<int> next;  // Dinic's per-node edge cursor
+    int source = 0;
+    int sink = 0;
+};
+
+#endif
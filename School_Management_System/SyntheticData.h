@@ -0,0 +1,135 @@
+#ifndef SYNTHETIC_DATA_H
+#define SYNTHETIC_DATA_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Deterministic synthetic school data for benchmarks and load tests.
+//
+// The same configuration (including the seed) always produces the same
+// names, enrollments, grades and attendance marks, on every platform: the
+// random numbers come from a fixed splitmix64 sequence rather than from the
+// implementation-defined std:: distributions.
+struct SyntheticConfig {
+    size_t students = 1000;
+    size_t courses = 50;
+    size_t subjects = 11;
+    double enrollmentDensity = 4.0;  // Average courses per student
+    uint64_t seed = 42;
+};
+
+class SyntheticData {
+public:
+    explicit SyntheticData(const SyntheticConfig& config) : config(config), state(config.seed) {}
+
+    const SyntheticConfig& settings() const { return config; }
+
+    // Next pseudo-random number of the sequence
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, bound)
+    uint64_t below(uint64_t bound) { return bound == 0 ? 0 : next() % bound; }
+
+    // IDs and names depend only on the index, so any record can be
+    // recreated without generating the ones before it
+    static std::string studentID(size_t index) { return "S" + std::to_string(index + 1); }
+    static std::string courseID(size_t index) { return "C" + std::to_string(index + 1); }
+
+    static std::string studentName(size_t index) {
+        static const char* const first[] = {
+            "John", "Mary", "Peter", "Grace", "James", "Faith", "David", "Esther",
+            "Brian", "Mercy", "Kevin", "Ann", "Dennis", "Joy", "Samuel", "Ruth"};
+        static const char* const last[] = {
+            "Kamau", "Wanjiru", "Otieno", "Achieng", "Mwangi", "Njeri", "Kiprop", "Chebet",
+            "Mutua", "Wambui", "Omondi", "Atieno", "Kariuki", "Nyambura", "Kibet", "Jepkosgei"};
+        const size_t F = sizeof(first) / sizeof(first[0]);
+        const size_t L = sizeof(last) / sizeof(last[0]);
+        // A third name keeps full names mostly distinct at large sizes
+        return std::string(first[index % F]) + " " + last[(index / F) % L] + " " +
+               last[(index / (F * L) + index) % L];
+    }
+
+    static std::string courseName(size_t index) {
+        static const char* const topics[] = {
+            "Mathematics", "English", "Kiswahili", "Chemistry", "Biology", "Physics",
+            "Computer Studies", "Geography", "History", "C.R.E", "Business Studies"};
+        const size_t T = sizeof(topics) / sizeof(topics[0]);
+        return std::string(topics[index % T]) + " " + std::to_string(index / T + 1);
+    }
+
+    // Course indexes one student is enrolled in: on average
+    // enrollmentDensity distinct courses, never more than there are
+    std::vector<size_t> enrollmentsFor(size_t student) {
+        std::vector<size_t> picked;
+        if (config.courses == 0) return picked;
+
+        size_t target = static_cast<size_t>(config.enrollmentDensity);
+        double fraction = config.enrollmentDensity - static_cast<double>(target);
+        if (static_cast<double>(below(1000)) < fraction * 1000) target++;
+        if (target > config.courses) target = config.courses;
+
+        // Start somewhere that depends on the student, then walk with random
+        // strides so popular and unpopular courses both appear
+        size_t course = (student * 7 + below(config.courses)) % config.courses;
+        while (picked.size() < target) {
+            bool taken = false;
+            for (size_t c : picked) taken = taken || c == course;
+            if (!taken) picked.push_back(course);
+            course = (course + 1 + below(config.courses)) % config.courses;
+        }
+        return picked;
+    }
+
+    // A grade between 0 and 100 with one decimal, bunched around 50
+    double grade() {
+        int tenths = static_cast<int>(below(401) + below(401) + below(201));  // 0..1000
+        return tenths / 10.0;
+    }
+
+    // (student, subject) pairs for attendance marking, both 0-based
+    std::vector<std::pair<size_t, size_t>> attendanceMarks(size_t count) {
+        std::vector<std::pair<size_t, size_t>> marks;
+        marks.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            marks.emplace_back(below(config.students), below(config.subjects));
+        }
+        return marks;
+    }
+
+    // Write a complete data file in StudentEnrollment's text format
+    // ("ID|Name" courses, "---", then "ID|Name|course|..." students).
+    // Capacities are left unlimited so every generated enrollment is valid.
+    bool writeEnrollmentText(const std::string& path) {
+        std::FILE* out = std::fopen(path.c_str(), "wb");
+        if (!out) return false;
+
+        std::string line;
+        for (size_t c = 0; c < config.courses; ++c) {
+            line = courseID(c) + "|" + courseName(c) + "\n";
+            std::fwrite(line.data(), 1, line.size(), out);
+        }
+        std::fputs("---\n", out);
+        for (size_t s = 0; s < config.students; ++s) {
+            line = studentID(s) + "|" + studentName(s);
+            for (size_t c : enrollmentsFor(s)) line += "|" + courseID(c);
+            line += "\n";
+            std::fwrite(line.data(), 1, line.size(), out);
+        }
+        bool ok = !std::ferror(out);
+        return std::fclose(out) == 0 && ok;
+    }
+
+private:
+    SyntheticConfig config;
+    uint64_t state;
+};
+
+#endif
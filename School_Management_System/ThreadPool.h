@@ -0,0 +1,94 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads for batches of independent jobs.
+//
+// The threads are started once and sleep between batches. A batch hands
+// out job indexes through one atomic counter, so cheap jobs and expensive
+// ones balance out across the workers by themselves.
+class ThreadPool {
+public:
+    // threads = 0: one per hardware thread
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t worker = 0; worker < threads; ++worker) {
+            workers.emplace_back([this, worker] { run(worker); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // Call job(index, worker) for every index in [0, count) and return once
+    // all calls have finished. worker (below size()) names the calling
+    // thread, for per-thread scratch space. One batch at a time.
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)>& job) {
+        if (count == 0) return;
+        std::unique_lock<std::mutex> lock(mutex);
+        batch = &job;
+        batchSize = count;
+        next.store(0, std::memory_order_relaxed);
+        running = workers.size();
+        generation++;
+        lock.unlock();
+        wake.notify_all();
+
+        lock.lock();
+        done.wait(lock, [this] { return running == 0; });
+        batch = nullptr;
+    }
+
+private:
+    void run(size_t worker) {
+        size_t seen = 0;
+        while (true) {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            const std::function<void(size_t, size_t)>& job = *batch;
+            size_t count = batchSize;
+            lock.unlock();
+
+            for (size_t index; (index = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+                job(index, worker);
+            }
+
+            lock.lock();
+            if (--running == 0) done.notify_all();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;  // A batch started, or the pool is closing
+    std::condition_variable done;  // The last worker finished the batch
+    const std::function<void(size_t, size_t)>* batch = nullptr;
+    size_t batchSize = 0;
+    std::atomic<size_t> next{0};
+    size_t running = 0;       // Workers still busy with the current batch
+    size_t generation = 0;    // Batches started so far
+    bool stopping = false;
+};
+
+#endif